@@ -0,0 +1,152 @@
+#include "shared/common/Common.h"
+
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Tooling/Tooling.h"
+
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+std::unique_ptr<clang::ASTUnit> buildAST(const std::string & code)
+{
+    auto ast = clang::tooling::buildASTFromCodeWithArgs(code, {"-std=c++17"}, "input.cpp");
+    if (!ast || ast->getDiagnostics().hasErrorOccurred()) {
+        llvm::report_fatal_error("benchmark snippet doesn't compile");
+    }
+    return ast;
+}
+
+template <class Decl>
+const Decl * findDecl(clang::ASTUnit & ast, const llvm::StringRef name)
+{
+    for (const auto * decl : ast.getASTContext().getTranslationUnitDecl()->decls()) {
+        if (const auto * named = clang::dyn_cast<Decl>(decl); named && named->getName() == name) {
+            return named;
+        }
+    }
+    llvm::report_fatal_error("benchmark snippet doesn't declare '" + name + "'");
+}
+
+// value of the single 'return' statement of the function 'name'
+const clang::Expr * findReturnValue(clang::ASTUnit & ast, const llvm::StringRef name)
+{
+    const auto * body = clang::cast<clang::CompoundStmt>(findDecl<clang::FunctionDecl>(ast, name)->getBody());
+    return clang::cast<clang::ReturnStmt>(body->body_back())->getRetValue();
+}
+
+// '(((x.a[0] + x.f()) * (x.a[1] + x.f())) * ...)' nested 'depth' times
+std::string makeNestedExpr(const int depth)
+{
+    std::string expr = "x.a[0]";
+    for (int i = 1; i <= depth; ++i) {
+        const auto idx = std::to_string(i % 8);
+        expr = "(" + expr + " + x.f()) * (x.a[" + idx + "] - " + idx + ")";
+    }
+    return expr;
+}
+
+void BM_IsIdenticalStmt(benchmark::State & state, const bool ignore_side_effects)
+{
+    const auto expr = makeNestedExpr(static_cast<int>(state.range(0)));
+    const auto ast = buildAST(
+            "struct X { int a[8]; int f() const; };\n"
+            "int f1(const X & x) { return " + expr + "; }\n"
+            "int f2(const X & x) { return " + expr + "; }\n");
+
+    const auto & ctx = ast->getASTContext();
+    const auto * lhs = findReturnValue(*ast, "f1");
+    const auto * rhs = findReturnValue(*ast, "f2");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ica::isIdenticalStmt(ctx, lhs, rhs, ignore_side_effects));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK_CAPTURE(BM_IsIdenticalStmt, side_effects, false)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+BENCHMARK_CAPTURE(BM_IsIdenticalStmt, ignore_side_effects, true)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+
+void BM_StructuralHash(benchmark::State & state)
+{
+    const auto expr = makeNestedExpr(static_cast<int>(state.range(0)));
+    const auto ast = buildAST(
+            "struct X { int a[8]; int f() const; };\n"
+            "int f(const X & x) { return " + expr + "; }\n");
+
+    const auto * value = findReturnValue(*ast, "f");
+
+    for (auto _ : state) {
+        // fresh hasher per iteration: measures hashing of the whole tree, not a cache lookup
+        ica::StructuralHasher hasher;
+        benchmark::DoNotOptimize(hasher(value));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_StructuralHash)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+
+void BM_ExtractDeclRef(benchmark::State & state)
+{
+    // 'x.next().next()...next().v[0]' chain of 'depth' calls returning references
+    std::string expr = "x";
+    for (int i = 0; i < state.range(0); ++i) {
+        expr += ".next()";
+    }
+    expr += ".v[0]";
+
+    const auto ast = buildAST(
+            "struct X { int v[4]; X & next(); };\n"
+            "int f(X & x) { return " + expr + "; }\n");
+
+    const auto * value = findReturnValue(*ast, "f");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ica::extractDeclRef(value));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ExtractDeclRef)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+constexpr auto * iterator_code =
+        "struct Value { int v; };\n"
+        "struct ValueIterator {\n"
+        "    ValueIterator(const ValueIterator &);\n"
+        "    ValueIterator & operator = (const ValueIterator &);\n"
+        "    ~ValueIterator();\n"
+        "    ValueIterator & operator ++ ();\n"
+        "    ValueIterator operator ++ (int);\n"
+        "    const Value & operator * () const;\n"
+        "    const Value * operator -> () const;\n"
+        "    bool operator == (const ValueIterator &) const;\n"
+        "    bool operator != (const ValueIterator &) const;\n"
+        "};\n"
+        "ValueIterator begin();\n"
+        "const Value & front();\n";
+
+void BM_IsIterator(benchmark::State & state)
+{
+    const auto ast = buildAST(iterator_code);
+    const auto * record = findDecl<clang::CXXRecordDecl>(*ast, "ValueIterator");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ica::isIterator(record));
+    }
+}
+BENCHMARK(BM_IsIterator);
+
+void BM_AsRefType(benchmark::State & state, const char * function_name)
+{
+    const auto ast = buildAST(iterator_code);
+    const auto type = findDecl<clang::FunctionDecl>(*ast, function_name)->getReturnType();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ica::asRefType(type));
+    }
+}
+BENCHMARK_CAPTURE(BM_AsRefType, iterator, "begin");
+BENCHMARK_CAPTURE(BM_AsRefType, reference, "front");
+
+} // namespace anonymous
+
+BENCHMARK_MAIN();
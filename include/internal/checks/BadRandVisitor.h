@@ -24,6 +24,12 @@ class BadRandVisitor : public Visitor<BadRandVisitor>
 
 public:
     static constexpr inline auto check_names = make_check_names(bad_rand);
+    // Engine construction ('std::mt19937 gen;') calls nothing by name, so the engine templates, which every engine typedef
+    // refers to, are listed: the check must not depend on other names <random> happens to declare (e.g. 'seed')
+    static constexpr inline auto trigger_names = make_trigger_names("rand", "random_shuffle", "random_device", "seed",
+                                                                    "linear_congruential_engine", "mersenne_twister_engine",
+                                                                    "subtract_with_carry_engine", "discard_block_engine",
+                                                                    "independent_bits_engine", "shuffle_order_engine");
 
 public:
     BadRandVisitor(clang::CompilerInstance & ci, const Config & checks);
@@ -19,6 +19,8 @@
 #include "boost/range/iterator_range.hpp"
 
 #include <cstdint>
+#include <unordered_set>
+#include <vector>
 
 namespace ica {
 
@@ -28,9 +30,18 @@ class ForRangeConstVisitor : public Visitor<ForRangeConstVisitor>
 {
     static constexpr inline auto * for_range_const = "for-range-const";
     static constexpr inline auto * const_param = "const-param";
+    static constexpr inline auto * expensive_pass_by_value = "expensive-pass-by-value";
+    static constexpr inline auto * range_for_copy = "range-for-copy";
+    static constexpr inline auto * range_for_temporary = "range-for-temporary";
 
 public:
-    static constexpr inline auto check_names = make_check_names(for_range_const, const_param);
+    static constexpr inline auto check_names = make_check_names(for_range_const, const_param, expensive_pass_by_value, range_for_copy,
+                                                                range_for_temporary);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(expensive_pass_by_value, range_for_copy,
+                                                                                  range_for_temporary);
+    static constexpr inline auto option_declarations = make_option_declarations(
+        OptionDeclaration{expensive_pass_by_value, "min-bytes", OptionDeclaration::Unsigned},
+        OptionDeclaration{range_for_copy, "min-bytes", OptionDeclaration::Unsigned});
 
 public:
     ForRangeConstVisitor(clang::CompilerInstance & ci, const Config & checks);
@@ -43,6 +54,7 @@ public:
 
     bool VisitCXXMemberCallExpr(clang::CXXMemberCallExpr * member_call);
     bool VisitCallExpr(clang::CallExpr * call_expr);
+    bool VisitDeclRefExpr(clang::DeclRefExpr * decl_ref);
     bool VisitBinaryOperator(clang::BinaryOperator * bin_op);
     bool VisitUnaryOperator(clang::UnaryOperator * un_op);
     bool VisitCXXOperatorCallExpr(clang::CXXOperatorCallExpr * op_call);
@@ -51,6 +63,7 @@ public:
     bool dataTraverseStmtPost(clang::Stmt * stmt);
 
     void printDiagnostic(clang::ASTContext &) {}
+    void finishTranslationUnit(clang::ASTContext &);
     void clear() {};
 
 private:
@@ -117,6 +130,16 @@ private:
     bool hasConstOverload(const clang::CXXMethodDecl * method_decl);
     RefTypeInfo getRefTypeInfo(const clang::QualType & type);
     bool isMutRef(const clang::QualType & type);
+    /// Copyable class, which is either non-trivially copyable or has at least 'min_bytes' size
+    bool isExpensiveToCopy(const clang::QualType & type, std::uint64_t min_bytes);
+    /// Reports the parameter at once, if it can't be fixed automatically,
+    /// otherwise at the end of the translation unit, when every reference to the function is known
+    void reportPassByValue(const clang::ParmVarDecl * parm);
+    void fixPassByValue(const clang::ParmVarDecl * parm);
+    void reportLoopVarCopy(const clang::CXXForRangeStmt * for_stmt);
+    /// Reference loop variable bound to a temporary, which the element is converted to: a hidden copy,
+    /// if the types differ in qualifiers of template arguments only, otherwise a conversion to an expensive type
+    void checkLoopVarTemporary(const clang::CXXForRangeStmt * for_stmt);
 
     void addMutRefProducer(const clang::Expr * expr, const clang::Expr * prnt, const clang::ValueDecl * intied = nullptr);
     bool producesMutRef(const clang::Expr * expr);
@@ -146,9 +169,24 @@ private:
     std::set<SubExpr, SubExprCmp> m_mb_refs;
     MemorizingFunctor<decltype(&isIterator)> m_is_iterator{&isIterator};
 
+    /// parameters to pass by reference, which are fixed at the end of the translation unit
+    std::vector<const clang::ParmVarDecl *> m_fixable_by_value_parms;
+    /// references to the functions being called, the other references make the signature fixed
+    std::unordered_set<const clang::DeclRefExpr *> m_callee_refs;
+    /// functions referenced other than by a call, e.g. their addresses are stored in a table of callbacks
+    std::unordered_set<const clang::FunctionDecl *> m_referenced_functions;
+
     DiagnosticID m_for_range_const_id = 0;
     DiagnosticID m_const_param_id = 0;
     DiagnosticID m_const_rvalue_id = 0;
+    DiagnosticID m_pass_by_value_id = 0;
+    DiagnosticID m_range_for_copy_id = 0;
+    DiagnosticID m_range_for_temporary_id = 0;
+    DiagnosticID m_range_for_hidden_copy_id = 0;
+
+    static constexpr inline std::uint64_t default_min_bytes = 64;
+    std::uint64_t m_min_bytes = default_min_bytes;
+    std::uint64_t m_range_for_copy_min_bytes = default_min_bytes;
 };
 
 } // namespace ica
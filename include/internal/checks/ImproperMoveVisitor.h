@@ -18,6 +18,7 @@ class ImproperMoveVisitor : public Visitor<ImproperMoveVisitor>
 
 public:
     static constexpr inline auto check_names = make_check_names(improper_move);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(improper_move);
 
 public:
     ImproperMoveVisitor(clang::CompilerInstance & ci, const Config & m_checks);
@@ -20,6 +20,7 @@ class MiscellaneousVisitor : public Visitor<MiscellaneousVisitor>
 
 public:
     static constexpr auto check_names = make_check_names(const_cast_member, temporary_in_ctor, static_keyword);
+    static constexpr auto weighted_check_names = make_weighted_check_names(temporary_in_ctor);
 
     MiscellaneousVisitor(clang::CompilerInstance & ci, const Config & checks);
 
@@ -16,6 +16,7 @@ class ReturnValueVisitor : public Visitor<ReturnValueVisitor>
 
 public:
     static constexpr auto check_names = make_check_names(return_value_type);
+    static constexpr auto weighted_check_names = make_weighted_check_names(return_value_type);
 
 public:
     ReturnValueVisitor(clang::CompilerInstance & ci, const Config & checks);
@@ -17,6 +17,11 @@ public:
 
 public:
     static constexpr inline auto check_names = make_check_names(no_named_object);
+    static constexpr inline auto trigger_names = make_trigger_names(
+        "isalnum", "isalpha", "islower", "isupper",
+        "isdigit", "isxdigit", "iscntrl", "isgraph",
+        "isspace", "isblank", "isprint", "ispunct",
+        "tolower", "toupper");
 
 public:
     bool VisitCallExpr(clang::CallExpr * expr);
@@ -14,6 +14,8 @@ public:
     explicit EmplaceDefaultValueVisitor(clang::CompilerInstance & ci, const Config & config);
 
     static constexpr inline auto check_names = make_check_names(emplace_default_value);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(emplace_default_value);
+    static constexpr inline auto trigger_names = make_trigger_names("emplace", "try_emplace", "emplace_hint");
 
     bool VisitCXXMemberCallExpr(clang::CXXMemberCallExpr * expr);
 
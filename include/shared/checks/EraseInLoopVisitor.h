@@ -20,6 +20,8 @@ public:
 
 public:
     static constexpr inline auto check_names = make_check_names(find_emplace);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(find_emplace);
+    static constexpr inline auto trigger_names = make_trigger_names("erase");
 
 public:
     bool VisitForStmt(clang::ForStmt * expr);
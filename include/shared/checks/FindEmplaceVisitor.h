@@ -8,6 +8,7 @@
 #include "clang/AST/ExprCXX.h"
 #include "clang/AST/Type.h"
 
+#include <map>
 #include <string>
 #include <utility>
 #include <tuple>
@@ -22,16 +23,26 @@ class FindEmplaceVisitor : public Visitor<FindEmplaceVisitor>
     using VarAndCallExprs = std::vector<VarAndCallExpr>;
 
     using ContainerKeyFind = std::tuple<const clang::Expr *, const clang::Expr *, const clang::Expr *>;
-    using IteratorsFind = std::map<const clang::VarDecl *, ContainerKeyFind>;
+
+    /// Iterators initialized by 'find' in a compound statement
+    struct IteratorsFind
+    {
+        std::map<const clang::VarDecl *, ContainerKeyFind> by_var;
+        /// structural hash of (container, key) -> iterator, candidates for 'getSameAsFindVar'
+        std::unordered_multimap<std::size_t, const clang::VarDecl *> by_hash;
+    };
 
     static constexpr auto * find_emplace = "find-emplace";
     static constexpr auto * try_emplace = "try_emplace-instead-emplace";
+    static constexpr auto * double_lookup = "double-lookup";
 
 public:
     explicit FindEmplaceVisitor(clang::CompilerInstance & ci, const Config & config);
 
 public:
-    static constexpr inline auto check_names = make_check_names(find_emplace, try_emplace);
+    static constexpr inline auto check_names = make_check_names(find_emplace, try_emplace, double_lookup);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(find_emplace, try_emplace, double_lookup);
+    static constexpr inline auto trigger_names = make_trigger_names("find", "count", "contains", "emplace", "emplace_hint");
 
 public:
     bool dataTraverseStmtPre(clang::Stmt * stmt);
@@ -40,6 +51,8 @@ public:
     bool VisitVarDecl(clang::VarDecl * decl);
     bool VisitCXXMemberCallExpr(clang::CXXMemberCallExpr * expr);
     bool VisitCXXOperatorCallExpr(clang::CXXOperatorCallExpr * expr);
+    bool VisitIfStmt(clang::IfStmt * stmt);
+    bool VisitConditionalOperator(clang::ConditionalOperator * expr);
 
     void clear();
     void printDiagnostic(clang::ASTContext & context) { }
@@ -52,7 +65,10 @@ private:
                           const std::string_view func_name,
                           const clang::QualType & type);
     void reportCompoundStmt();
+    std::size_t hashContainerAndKey(const clang::Expr * cont, const clang::Expr * key);
     void makeTryEmplaceReport(const clang::CXXMemberCallExpr * memberCallExpr);
+    /// Reports lookups of the key checked by 'count'/'contains' in 'cond' within the branches
+    void checkDoubleLookup(const clang::Expr * cond, const clang::Stmt * then_stmt, const clang::Stmt * else_stmt);
 
 private:
     struct GetKeyTypeFunctor
@@ -62,11 +78,14 @@ private:
     DiagnosticID m_find_emplace_warn_id = 0;
     DiagnosticID m_try_emplace_warn_id = 0;
     DiagnosticID m_note_id = 0;
+    DiagnosticID m_double_lookup_warn_id = 0;
+    DiagnosticID m_lookup_note_id = 0;
     VarAndCallExprs m_calls;
     clang::CompoundStmt * m_curr_stmt;
     std::unordered_map<clang::CompoundStmt *, clang::CompoundStmt *>  m_parent_of;
     std::unordered_map<clang::CompoundStmt *, IteratorsFind> m_stmt_iterators;
     MemorizingFunctor<GetKeyTypeFunctor> m_mem_func_get_key_type;
+    StructuralHasher m_hasher;
 };
 
 } // namespace ica
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "shared/common/Effects.h"
+#include "shared/common/Visitor.h"
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace ica {
+
+/// Checks functions marked as hot ('[[clang::annotate("ica::hot")]]' or '// ICA-HOT' comment)
+/// and everything they call within the translation unit
+class HotPathVisitor : public Visitor<HotPathVisitor>
+{
+    static constexpr inline auto * hot_path_allocation = "hot-path-allocation";
+    static constexpr inline auto * hot_path_blocking = "hot-path-blocking";
+    static constexpr inline auto * hot_path_throw = "hot-path-throw";
+
+public:
+    explicit HotPathVisitor(clang::CompilerInstance & ci, const Config & config);
+
+public:
+    static constexpr inline auto check_names = make_check_names(hot_path_allocation, hot_path_blocking, hot_path_throw);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(hot_path_allocation, hot_path_blocking, hot_path_throw);
+
+public:
+    bool VisitFunctionDecl(clang::FunctionDecl * decl);
+
+    /// Hot function templates are checked by their instantiations
+    bool shouldVisitTemplateInstantiations() const
+    { return true; }
+
+    void printDiagnostic(clang::ASTContext & context);
+
+private:
+    /// Reports every call site with 'effect' reachable from 'hot_function', with the shortest call chain as notes.
+    /// Only the callees, whose effect summary has 'effect', are walked
+    void reportEffect(const clang::FunctionDecl * hot_function, Effect effect, DiagnosticID warn_id);
+
+private:
+    DiagnosticID m_allocation_id = 0;
+    DiagnosticID m_blocking_id = 0;
+    DiagnosticID m_throw_id = 0;
+    DiagnosticID m_call_note_id = 0;
+    std::vector<const clang::FunctionDecl *> m_hot_functions;
+    /// a site reached from several hot functions is reported for each of them
+    std::set<std::tuple<const clang::FunctionDecl *, const clang::Expr *, Effect>> m_reported;
+};
+
+} // namespace ica
@@ -15,6 +15,7 @@ public:
 
 public:
     static constexpr inline auto check_names = make_check_names(release_lock);
+    static constexpr inline auto trigger_names = make_trigger_names("release");
 
 public:
     bool VisitCXXMemberCallExpr(clang::CXXMemberCallExpr * ce);
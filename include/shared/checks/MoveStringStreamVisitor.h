@@ -21,6 +21,8 @@ public:
 
 public:
     static constexpr inline auto check_names = make_check_names(move_string_stream);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(move_string_stream);
+    static constexpr inline auto trigger_names = make_trigger_names("str");
 
 public:
     bool VisitVarDecl(clang::VarDecl * decl);
@@ -2,26 +2,46 @@
 
 #include "shared/common/Visitor.h"
 
+#include "llvm/ADT/DenseSet.h"
+
 namespace ica {
 
 class NoexceptVisitor : public Visitor<NoexceptVisitor>
 {
     static constexpr auto * noexcept_check = "redundant-noexcept";
+    static constexpr auto * missing_noexcept = "missing-noexcept";
+    static constexpr auto * throwing_move_element = "throwing-move-element";
 
 public:
 
     explicit NoexceptVisitor(clang::CompilerInstance & ci, const Config & config);
 
-    static constexpr auto check_names = make_check_names(noexcept_check);
+    static constexpr auto check_names = make_check_names(noexcept_check, missing_noexcept, throwing_move_element);
+    static constexpr auto weighted_check_names = make_weighted_check_names(noexcept_check, missing_noexcept, throwing_move_element);
 
     bool VisitFunctionDecl(clang::FunctionDecl * decl);
 
-    void printDiagnostic(clang::ASTContext &) { }
+    void printDiagnostic(clang::ASTContext & context);
+
+private:
+
+    /// Move operations and 'swap' which can't throw, but aren't declared as 'noexcept'
+    void checkMissingNoexcept(const clang::FunctionDecl * decl);
+
+    /// Element types of 'std::vector' and 'std::deque' specializations, which are copied instead of moved
+    /// as their move constructor isn't 'noexcept'
+    void checkContainerElements(clang::ASTContext & context, llvm::StringRef container_name);
 
 private:
 
+    /// Sema resolves exception specifications of defaulted functions, it's created after the visitor
+    clang::CompilerInstance & m_ci;
     DiagnosticID m_warn_id = 0;
     DiagnosticID m_note_id = 0;
+    DiagnosticID m_missing_id = 0;
+    DiagnosticID m_element_id = 0;
+    DiagnosticID m_element_note_id = 0;
+    llvm::DenseSet<const clang::CXXRecordDecl *> m_reported_elements;
 };
 
 } // namespace ica
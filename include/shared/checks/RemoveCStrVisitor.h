@@ -13,6 +13,8 @@ public:
 
 public:
     static constexpr inline auto check_names = make_check_names(remove_c_str);
+    static constexpr inline auto weighted_check_names = make_weighted_check_names(remove_c_str);
+    static constexpr inline auto trigger_names = make_trigger_names("c_str");
 
 public:
     bool VisitCXXMemberCallExpr(clang::CXXMemberCallExpr * expr);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include "clang/Basic/SourceManager.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ica {
+
+/// Expression of a function body which calls something (a function, a constructor, operator new/delete,
+/// a lambda passed to an algorithm of namespace std) or has an effect of its own ('throw')
+struct CallSite
+{
+    const clang::Expr * expr = nullptr;
+    /// null for 'throw' and indirect calls
+    const clang::FunctionDecl * callee = nullptr;
+    /// within a 'try' block: the exceptions may be caught
+    bool in_try = false;
+    /// within a lambda body: executed when the lambda is called, not by the function itself
+    bool in_lambda = false;
+};
+
+/// Intra translation unit call graph. It's built lazily: call sites of a function are collected
+/// on the first request, so only the functions reachable from the queried ones are walked
+class CallGraph
+{
+public:
+    /// Call sites of the function body (and of constructor initializers), lambda bodies included
+    const std::vector<CallSite> & getCallSites(const clang::FunctionDecl * function);
+
+    /// Definition of 'callee' to follow: a function with a body, which is not in a system header
+    /// and not in namespace std, whose behavior is rather known by name. Null otherwise
+    static const clang::FunctionDecl * getFollowedDefinition(const clang::FunctionDecl * callee,
+                                                             const clang::SourceManager & source_manager);
+
+private:
+    // node based: returned references stay valid while other functions are added
+    std::unordered_map<const clang::FunctionDecl *, std::vector<CallSite>> m_call_sites;
+};
+
+} // namespace ica
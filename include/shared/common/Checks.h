@@ -91,10 +91,15 @@ public:
     {
         m_checks.clear();
         m_all = Check::Disabled;
+        m_has_all = false;
     }
 
     std::optional<std::string> parse(std::string_view checks);
 
+    /// Applies explicitly specified states of 'overrides' on top of the current ones,
+    /// same as if 'overrides' check list was parsed after the current one
+    void merge(const Checks & overrides);
+
     const Check operator [] (std::string_view check) const noexcept;
 
 private:
@@ -102,6 +107,7 @@ private:
 
 private:
     Check m_all = Check::Disabled;
+    bool m_has_all = false;
     std::unordered_map<std::string_view, Check> m_checks;
 };
 
@@ -3,6 +3,7 @@
 #include "clang/AST/AST.h"
 #include "clang/AST/ASTConsumer.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringRef.h"
 
 #include "boost/compressed_pair.hpp"
@@ -179,6 +180,20 @@ bool isIdenticalStmt(
         const clang::Stmt * stmt2,
         const bool ignore_side_effects);
 
+/// Structural hash of a statement, consistent with 'isIdenticalStmt': identical statements
+/// have equal hashes, so the tree comparison is needed only when hashes are equal.
+/// Hashes are memoized per statement, shared subtrees are hashed once
+class StructuralHasher
+{
+public:
+    std::size_t operator()(const clang::Stmt * stmt);
+
+    void clear() { m_cache.clear(); }
+
+private:
+    llvm::DenseMap<const clang::Stmt *, std::size_t> m_cache;
+};
+
 /*
  *  Extracts a variable that is referenced in an expression
  *  e.g. obj from obj.field, or obj.method(), or obj[idx] or *obj
@@ -196,6 +211,21 @@ RefTypeInfo asRefType(const clang::QualType & type);
 
 RefTypeInfo isIterator(const clang::CXXRecordDecl * decl);
 
+// exceptions
+/// Function is declared as not throwing: 'noexcept', 'throw()', '__attribute__((nothrow))'.
+/// Unevaluated specifications (e.g. of implicit members) are assumed to be noexcept
+bool isNoexcept(const clang::FunctionDecl * func_decl);
+
+/// '__assert_fail' of 'assert' macro, which is not 'noexcept', but never throws
+bool isAssert(const clang::FunctionDecl * func_decl);
+
+// locks
+/// 'std::unique_lock' or 'std::shared_lock': the locks which can release the owned mutex
+bool isStdReleasableLock(const clang::CXXRecordDecl * decl);
+
+/// RAII lock of namespace std: 'std::lock_guard', 'std::scoped_lock' or a releasable one
+bool isStdLock(const clang::CXXRecordDecl * decl);
+
 template <class F>
 struct MemberFunctionTraits;
 
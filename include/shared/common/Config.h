@@ -1,7 +1,14 @@
 #pragma once
 
 #include "shared/common/Checks.h"
+#include "shared/common/FileFilter.h"
+#include "shared/common/Options.h"
+#include "shared/common/Profile.h"
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <chrono>
 #include <optional>
 #include <string>
 #include <vector>
@@ -10,20 +17,81 @@ namespace ica {
 
 class Config
 {
+public:
+    enum class Mode
+    {
+        Add,     // along with the compilation ('-add-plugin')
+        Replace, // instead of the compilation ('-plugin'), no code generation
+    };
+
 public:
     Config();
 
     std::optional<std::string> parse(const std::vector<std::string> & args);
 
+    /// Applies '.ica.yaml' files found from the directory of 'main_file' upwards.
+    /// Files are more specific than the plugin arguments, so their settings take precedence
+    std::optional<std::string> loadConfigFiles(llvm::StringRef main_file);
+
+    /// Converts the option values to the types of their declarations, see Options::resolve.
+    /// Should be called once the options of the plugin arguments and '.ica.yaml' files are merged
+    std::optional<std::string> resolveOptions(llvm::ArrayRef<OptionDeclaration> declarations)
+    { return m_options.resolve(declarations); }
+
+    /// Whether the translation unit of 'main_file' falls into the analyzed bucket of 'sample=k/n'.
+    /// Buckets are assigned by a hash of the path relative to the repository root, so the choice is deterministic
+    /// between builds, even if they check the repository out into different directories
+    bool isSampled(llvm::StringRef main_file) const;
+
     bool get_use_url() const
     { return m_use_url; }
 
+    Mode get_mode() const
+    { return m_mode; }
+
     const Checks & get_checks() const
     { return m_checks; }
 
+    const Options & get_options() const
+    { return m_options; }
+
+    const FileFilter & get_file_filter() const
+    { return m_file_filter; }
+
+    /// Analyze only the main file and the header paired with it ('foo.cpp' and 'foo.h')
+    bool get_main_file_only() const
+    { return m_main_file_only; }
+
+    /// Maximum number of diagnostics of a check reported per file
+    std::optional<unsigned> get_max_diags_per_file() const
+    { return m_max_diags_per_file; }
+
+    /// Time the plugin may spend on a translation unit before skipping the most expensive checks
+    std::optional<std::chrono::milliseconds> get_budget() const
+    { return m_budget; }
+
+    /// Sampling profile of 'profile=<file>', nullptr if it isn't given
+    const Profile * get_profile() const
+    { return m_profile; }
+
+private:
+    struct Sample
+    {
+        unsigned bucket = 0;
+        unsigned buckets = 1;
+    };
+
 private:
     Checks m_checks;
+    Options m_options;
+    FileFilter m_file_filter;
+    std::optional<std::chrono::milliseconds> m_budget;
+    std::optional<Sample> m_sample;
+    std::optional<unsigned> m_max_diags_per_file;
+    const Profile * m_profile = nullptr;
+    Mode m_mode = Mode::Add;
     bool m_use_url = true;
+    bool m_main_file_only = false;
 };
 
 } // namespace ica
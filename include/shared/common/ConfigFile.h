@@ -0,0 +1,28 @@
+#pragma once
+
+#include "shared/common/Checks.h"
+#include "shared/common/Options.h"
+
+#include "llvm/ADT/StringRef.h"
+
+#include <optional>
+#include <string>
+
+namespace ica {
+
+/// Settings of '.ica.yaml' files applied to a directory: own file of the directory
+/// merged on top of the files found in its parent directories
+struct DirectoryConfig
+{
+    Checks checks;
+    Options options;
+    /// set if one of the files can't be read or parsed
+    std::optional<std::string> error;
+};
+
+/// Looks '.ica.yaml' up from 'directory' to the root (similar to '.clang-tidy').
+/// The result is memoized per directory for the process lifetime, so every file is read
+/// and parsed once, no matter how many translation units the process compiles
+const DirectoryConfig & getDirectoryConfig(llvm::StringRef directory);
+
+} // namespace ica
@@ -6,12 +6,19 @@
 #include "internal/checks/ExclusiveUnitedVisitors.h"
 
 #include "shared/common/Config.h"
+#include "shared/common/DiagnosticLimiter.h"
+#include "shared/common/DiagnosticsBuilder.h"
+#include "shared/common/EffectSummaries.h"
+#include "shared/common/LocationFilter.h"
+#include "shared/common/ProfileFilter.h"
+#include "shared/common/TimeBudget.h"
 #include "shared/common/UnitedVisitor.h"
 
 #include "shared/checks/CTypeCharVisitor.h"
 #include "shared/checks/EmplaceDefaultValueVisitor.h"
 #include "shared/checks/EraseInLoopVisitor.h"
 #include "shared/checks/FindEmplaceVisitor.h"
+#include "shared/checks/HotPathVisitor.h"
 #include "shared/checks/InlineMethodsInClassBodyVisitor.h"
 #include "shared/checks/LockGuardReleaseVisitor.h"
 #include "shared/checks/NoexceptVisitor.h"
@@ -28,6 +35,7 @@ class Consumer : public clang::ASTConsumer
         CTypeCharVisitor,
         EmplaceDefaultValueVisitor,
         EraseInLoopVisitor,
+        HotPathVisitor,
         InlineMethodsInClassBodyVisitor,
         LockGuardReleaseVisitor,
         NoexceptVisitor,
@@ -40,15 +48,38 @@ class Consumer : public clang::ASTConsumer
 public:
     explicit Consumer(clang::CompilerInstance & ci, Config config);
 
+    /// Options read by the checks and by the plugin itself (e.g. 'profile.hot-percent')
+    static llvm::ArrayRef<OptionDeclaration> getOptionDeclarations();
+
     virtual void HandleTranslationUnit(clang::ASTContext & context) override;
     virtual bool HandleTopLevelDecl(clang::DeclGroupRef decl_group) override;
+    virtual void HandleTagDeclDefinition(clang::TagDecl * decl) override;
+    virtual void HandleCXXImplicitFunctionInstantiation(clang::FunctionDecl * decl) override;
+
+private:
+    /// Runs the top level declaration visitor on a local declaration
+    void traverseTopLevelDecl(clang::Decl * decl);
+
+    /// Skips the most expensive of the remaining checks if the time budget is exceeded
+    void checkBudget();
+    void reportSkippedChecks();
 
 private:
     Config m_config;
+    clang::DiagnosticsEngine & m_diag;
 
     TranslationUnitUV m_translation_unit_visitor;
 
     TopLevelDeclUV m_top_level_decl_visitor;
+
+    EffectSummaries m_effect_summaries;
+    std::optional<LocationFilter> m_location_filter;
+    std::optional<DiagnosticLimiter> m_diagnostic_limiter;
+    std::optional<ProfileFilter> m_profile_filter;
+    std::optional<TimeBudget> m_budget;
+    std::vector<std::string_view> m_skipped_checks;
+    /// Instantiations of PCH or module templates made by the translation unit
+    std::vector<clang::Decl *> m_ast_file_instantiations;
 };
 
 } // namespace ica
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace ica {
+
+/// Per translation unit: caps the number of diagnostics of each check per file ('max-diags-per-file=').
+/// The decision is made before DiagnosticsEngine::Report, so suppressed diagnostics aren't formatted at all
+class DiagnosticLimiter
+{
+public:
+    DiagnosticLimiter(const unsigned max_per_file, const clang::SourceManager & source_manager)
+        : m_max_per_file(max_per_file)
+        , m_source_manager(source_manager)
+    { }
+
+    bool shouldReport(clang::SourceLocation loc, std::string_view check_name);
+
+    /// Reports "N more <check> diagnostics suppressed in <file>" remarks
+    void reportSuppressed(clang::DiagnosticsEngine & diag) const;
+
+private:
+    const unsigned m_max_per_file;
+    const clang::SourceManager & m_source_manager;
+    std::map<std::pair<clang::FileID, std::string_view>, unsigned> m_counts;
+};
+
+} // namespace ica
@@ -4,6 +4,8 @@
 #include "clang/Basic/Diagnostic.h"
 
 #include <cstddef>
+#include <optional>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -14,39 +16,57 @@ using DiagnosticID = unsigned int;
 class DiagnosticBuilder;
 
 inline DiagnosticBuilder report(clang::DiagnosticsEngine &, DiagnosticID);
-inline DiagnosticBuilder report(clang::DiagnosticsEngine &, clang::SourceLocation, DiagnosticID);
+inline DiagnosticBuilder report(clang::DiagnosticsEngine &, clang::SourceLocation, DiagnosticID, std::optional<std::string> = std::nullopt);
+inline DiagnosticBuilder suppressedReport();
 
 class DiagnosticBuilder
 {
     friend DiagnosticBuilder report(clang::DiagnosticsEngine &, DiagnosticID);
-    friend DiagnosticBuilder report(clang::DiagnosticsEngine &, clang::SourceLocation, DiagnosticID);
+    friend DiagnosticBuilder report(clang::DiagnosticsEngine &, clang::SourceLocation, DiagnosticID, std::optional<std::string>);
+    friend DiagnosticBuilder suppressedReport();
 
     DiagnosticBuilder(
             clang::DiagnosticsEngine & de,
             const clang::SourceLocation & loc,
-            const DiagnosticID diag_id)
+            const DiagnosticID diag_id,
+            std::optional<std::string> trailing_value = std::nullopt)
         : m_builder(de.Report(loc, diag_id))
+        , m_trailing_value(std::move(trailing_value))
     { }
     DiagnosticBuilder(
             clang::DiagnosticsEngine & de,
             const DiagnosticID diag_id)
         : m_builder(de.Report(diag_id))
     { }
+    // suppressed diagnostic: arguments are ignored, nothing is reported
+    DiagnosticBuilder() = default;
 
 public:
     DiagnosticBuilder(const DiagnosticBuilder &) = delete;
     DiagnosticBuilder & operator = (const DiagnosticBuilder &) = delete;
 
+    // the trailing value follows the arguments added by the caller, the diagnostic is emitted afterwards
+    ~DiagnosticBuilder()
+    {
+        if (m_builder && m_trailing_value) {
+            m_builder->AddString(*m_trailing_value);
+        }
+    }
+
 public:
     auto && AddValue(clang::StringRef s) &&
     {
-        m_builder.AddString(std::move(s));
+        if (m_builder) {
+            m_builder->AddString(std::move(s));
+        }
         return std::move(*this);
     }
 
     auto && AddValue(const clang::NamedDecl * named_decl) &&
     {
-        m_builder.AddTaggedVal(reinterpret_cast<std::intptr_t>(named_decl), clang::DiagnosticsEngine::ArgumentKind::ak_nameddecl);
+        if (m_builder) {
+            m_builder->AddTaggedVal(reinterpret_cast<std::intptr_t>(named_decl), clang::DiagnosticsEngine::ArgumentKind::ak_nameddecl);
+        }
         return std::move(*this);
     }
 
@@ -57,13 +77,17 @@ public:
             ? clang::DiagnosticsEngine::ArgumentKind::ak_sint
             : clang::DiagnosticsEngine::ArgumentKind::ak_uint;
 
-        m_builder.AddTaggedVal(static_cast<std::intptr_t>(value), arg_kind);
+        if (m_builder) {
+            m_builder->AddTaggedVal(static_cast<std::intptr_t>(value), arg_kind);
+        }
         return std::move(*this);
     }
 
     auto && AddSourceRange(const clang::CharSourceRange range) &&
     {
-        m_builder.AddSourceRange(range);
+        if (m_builder) {
+            m_builder->AddSourceRange(range);
+        }
         return std::move(*this);
     }
 
@@ -74,12 +98,15 @@ public:
 
     auto && AddFixItHint(const clang::FixItHint & hint) &&
     {
-        m_builder.AddFixItHint(hint);
+        if (m_builder) {
+            m_builder->AddFixItHint(hint);
+        }
         return std::move(*this);
     }
 
 private:
-    clang::DiagnosticBuilder m_builder;
+    std::optional<clang::DiagnosticBuilder> m_builder;
+    std::optional<std::string> m_trailing_value;
 };
 
 inline DiagnosticBuilder report(
@@ -89,12 +116,19 @@ inline DiagnosticBuilder report(
     return {de, diag_id};
 }
 
+/// 'trailing_value' is the last argument of the diagnostic, after the ones added to the result
 inline DiagnosticBuilder report(
         clang::DiagnosticsEngine & de,
         const clang::SourceLocation loc,
-        const DiagnosticID diag_id)
+        const DiagnosticID diag_id,
+        std::optional<std::string> trailing_value)
+{
+    return {de, loc, diag_id, std::move(trailing_value)};
+}
+
+inline DiagnosticBuilder suppressedReport()
 {
-    return {de, loc, diag_id};
+    return {};
 }
 
 } // namespace ica
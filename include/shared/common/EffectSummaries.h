@@ -0,0 +1,54 @@
+#pragma once
+
+#include "shared/common/CallGraph.h"
+#include "shared/common/Effects.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <array>
+#include <vector>
+
+namespace ica {
+
+/// Per function summaries of effects (may throw, may allocate, may block), which take into account
+/// everything the function calls within the translation unit. A summary is computed on the first query
+/// for the functions reachable from the queried one at once, by fixed-point iteration,
+/// so recursion is handled and the following queries are lookups.
+/// A single instance lives as long as the translation unit, its call graph is shared by the checks
+class EffectSummaries
+{
+public:
+    explicit EffectSummaries(const clang::SourceManager & source_manager)
+        : m_source_manager(source_manager)
+    { }
+
+    /// Whether calling 'function' may have 'effect'. Functions which aren't followed (without a body,
+    /// from namespace std or system headers) are summarized by their call site only, see getDirectEffect
+    bool mayHave(const clang::FunctionDecl * function, Effect effect);
+
+    /// Whether the call site may have 'effect': by itself (see getDirectEffect, a throwing new expression
+    /// counts as well) or through the callee. The call sites of the summarized functions are classified the same way
+    bool mayHave(const CallSite & site, Effect effect);
+
+    bool mayThrow(const CallSite & site)
+    { return mayHave(site, Effect::Throw); }
+
+    CallGraph & getCallGraph()
+    { return m_call_graph; }
+
+private:
+    /// Whether the call site has 'effect' by itself, regardless of the callee body
+    static bool hasDirectEffect(const CallSite & site, Effect effect);
+
+    /// Definitions reachable from 'definition' without a summary yet, 'definition' included
+    std::vector<const clang::FunctionDecl *> collectUnsummarized(const clang::FunctionDecl * definition, Effect effect);
+
+private:
+    static constexpr std::size_t effects_count = static_cast<std::size_t>(Effect::Throw) + 1;
+
+    const clang::SourceManager & m_source_manager;
+    CallGraph m_call_graph;
+    std::array<llvm::DenseMap<const clang::FunctionDecl *, bool>, effects_count> m_summaries;
+};
+
+} // namespace ica
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "shared/common/CallGraph.h"
+
+#include <optional>
+#include <string>
+
+namespace ica {
+
+/// Effects of interest for latency critical code
+enum class Effect
+{
+    Allocation,
+    Blocking,
+    Throw,
+};
+
+/// What makes the call site have 'effect' by itself, not through the body of the callee
+/// (e.g. 'operator new', 'std::vector::push_back', 'std::mutex::lock'), nullopt if it doesn't have the effect
+std::optional<std::string> getDirectEffect(const CallSite & site, Effect effect);
+
+/// Whether 'effect' of the call site reaches the calling function: lambda bodies run when the lambda is called,
+/// exceptions within 'try' blocks may be caught, the ones of 'noexcept' callees terminate the program
+bool reachesCaller(const CallSite & site, Effect effect);
+
+} // namespace ica
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/GlobPattern.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ica {
+
+/// Path globs of 'include=' and 'exclude=' arguments, compiled once when arguments are parsed
+class FileFilter
+{
+public:
+    /// Parses comma separated list of globs
+    std::optional<std::string> parseInclude(std::string_view globs);
+    std::optional<std::string> parseExclude(std::string_view globs);
+
+    bool empty() const
+    { return m_include.empty() && m_exclude.empty(); }
+
+    /// 'paths' are different spellings of the same file (e.g. as written and the real one).
+    /// The file is accepted if any spelling matches one of 'include' globs (if there are any)
+    /// and no spelling matches 'exclude' globs
+    bool accepts(llvm::ArrayRef<llvm::StringRef> paths) const;
+
+private:
+    std::vector<llvm::GlobPattern> m_include;
+    std::vector<llvm::GlobPattern> m_exclude;
+};
+
+} // namespace ica
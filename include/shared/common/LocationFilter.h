@@ -0,0 +1,41 @@
+#pragma once
+
+#include "shared/common/Config.h"
+
+#include "clang/AST/DeclBase.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+namespace ica {
+
+/// Per translation unit: decides whether a declaration should be visited according to
+/// 'include='/'exclude=' path filters and 'main-file-only' mode. The decision is made once per FileID
+class LocationFilter
+{
+public:
+    LocationFilter(const Config & config, const clang::SourceManager & source_manager)
+        : m_file_filter(config.get_file_filter())
+        , m_main_file_only(config.get_main_file_only())
+        , m_source_manager(source_manager)
+    { }
+
+    /// Whether the configuration needs any filtering
+    static bool isNeeded(const Config & config)
+    { return !config.get_file_filter().empty() || config.get_main_file_only(); }
+
+    bool shouldVisit(const clang::Decl * decl);
+
+private:
+    bool computeShouldVisit(clang::FileID file_id) const;
+    bool isMainFileOrItsHeader(clang::FileID file_id, const clang::FileEntry & file_entry) const;
+
+private:
+    const FileFilter & m_file_filter;
+    const bool m_main_file_only;
+    const clang::SourceManager & m_source_manager;
+    llvm::DenseMap<clang::FileID, bool> m_should_visit_file;
+};
+
+} // namespace ica
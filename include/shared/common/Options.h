@@ -0,0 +1,95 @@
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+namespace ica {
+
+/// Tunable read by a check: 'check-name.option-name' with a value of 'type'
+struct OptionDeclaration
+{
+    enum Type
+    {
+        Bool, Unsigned, String,
+    };
+
+    std::string_view check;
+    std::string_view option;
+    Type type = String;
+};
+
+template <class ... Ts>
+constexpr auto make_option_declarations(const Ts & ... ts)
+{
+    return std::array<OptionDeclaration, sizeof...(Ts)>{ ts... };
+}
+
+/// Per-check tunables: 'check-name.option-name=value' pairs
+class Options
+{
+public:
+    Options() = default;
+
+    /// Parses comma separated list of 'check-name.option-name=value'
+    std::optional<std::string> parse(std::string_view options);
+
+    /// Applies 'overrides' on top of the current options, they take effect after the next 'resolve'
+    void merge(const Options & overrides);
+
+    /// Converts every parsed value to the type of its declaration.
+    /// Returns an error for an option, which isn't declared, or a value, which can't be converted
+    std::optional<std::string> resolve(llvm::ArrayRef<OptionDeclaration> declarations);
+
+    /// Returns the resolved value (bool, integral or std::string), nullopt if the option isn't set
+    template <class T>
+    std::optional<T> get(const std::string_view check, const std::string_view option) const
+    {
+        const auto it = m_values.find(makeKey(check, option));
+        if (it == m_values.end()) {
+            return std::nullopt;
+        }
+
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, std::string>) {
+            if (const auto * value = std::get_if<T>(&it->second)) {
+                return *value;
+            }
+        } else {
+            static_assert(std::is_integral_v<T>, "unsupported option type");
+            if (const auto * value = std::get_if<std::uint64_t>(&it->second)) {
+                return static_cast<T>(*value);
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    using Value = std::variant<bool, std::uint64_t, std::string>;
+
+private:
+    static std::string makeKey(const std::string_view check, const std::string_view option)
+    {
+        std::string key;
+        key.reserve(check.size() + option.size() + 1);
+        key.append(check).append(1, '.').append(option);
+        return key;
+    }
+
+    static std::optional<Value> convert(llvm::StringRef value, OptionDeclaration::Type type);
+
+private:
+    /// values as written, 'check-name.option-name' -> 'value'
+    std::unordered_map<std::string, std::string> m_options;
+    /// values converted by 'resolve'
+    std::unordered_map<std::string, Value> m_values;
+};
+
+} // namespace ica
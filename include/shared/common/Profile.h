@@ -0,0 +1,76 @@
+#pragma once
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ica {
+
+/// Sampling profile given by 'profile=<file>'. Each line of the file is either
+///   - a folded stack 'frame;frame;...;frame <samples>' (e.g. 'perf script | stackcollapse-perf.pl'),
+///     samples are accounted to every function of the stack (inclusive weight), or
+///   - a source range '<path>:<line>[-<last line>] <samples>'.
+/// Both kinds may describe the same run, so their samples are summed up separately.
+/// Empty lines and lines starting with '#' are ignored
+class Profile
+{
+public:
+    struct LineSamples
+    {
+        std::string path;
+        unsigned first_line = 0;
+        unsigned last_line = 0;
+        std::uint64_t samples = 0;
+    };
+
+public:
+    std::optional<std::string> load(llvm::StringRef path);
+    std::optional<std::string> parse(llvm::StringRef content);
+
+    /// Samples of a function with the qualified name, normalized by 'normalizeSymbol'
+    std::uint64_t getSymbolSamples(llvm::StringRef qualified_name) const;
+
+    /// Whether some profiled function has the unqualified name (cheap filter before 'getSymbolSamples')
+    bool hasUnqualifiedName(llvm::StringRef name) const
+    { return m_unqualified_names.count(name) != 0; }
+
+    const std::vector<LineSamples> & getLineSamples() const
+    { return m_lines; }
+
+    /// Sum of samples of the folded stacks
+    std::uint64_t getTotalStackSamples() const
+    { return m_total_stack_samples; }
+
+    /// Sum of samples of the source ranges
+    std::uint64_t getTotalLineSamples() const
+    { return m_total_line_samples; }
+
+    /// Drops what differs between a profiler frame and a qualified name of a declaration:
+    /// demangles, removes module prefix ('lib.so`'), offset ('+0x1f'), clone suffixes,
+    /// parameter list, cv-qualifiers and template arguments
+    static std::string normalizeSymbol(llvm::StringRef symbol);
+
+private:
+    llvm::StringMap<std::uint64_t> m_symbols;
+    llvm::StringMap<char> m_unqualified_names;
+    std::vector<LineSamples> m_lines;
+    std::uint64_t m_total_stack_samples = 0;
+    std::uint64_t m_total_line_samples = 0;
+};
+
+/// Profile of 'profile=<file>' along with the error of reading or parsing it
+struct ProfileFile
+{
+    Profile profile;
+    std::optional<std::string> error;
+};
+
+/// Loads the profile of 'path'. The result is memoized per path for the process lifetime, so the file
+/// is read and its symbols are demangled once, no matter how many translation units the process compiles
+const ProfileFile & getProfileFile(llvm::StringRef path);
+
+} // namespace ica
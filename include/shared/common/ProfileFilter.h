@@ -0,0 +1,105 @@
+#pragma once
+
+#include "shared/common/Config.h"
+#include "shared/common/DiagnosticsBuilder.h"
+#include "shared/common/Options.h"
+#include "shared/common/Profile.h"
+
+#include "clang/AST/Decl.h"
+#include "clang/Basic/DiagnosticIDs.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ica {
+
+/// Per translation unit: weight of the function enclosing a diagnostic according to 'profile=<file>'.
+/// Diagnostics of performance checks in cold functions are dropped, in hot ones - optionally reported with raised severity
+class ProfileFilter
+{
+public:
+    enum class Hotness
+    {
+        Cold, Warm, Hot,
+    };
+
+    struct Weight
+    {
+        Hotness hotness = Hotness::Warm;
+        std::uint64_t samples = 0;
+        double percent = 0;
+    };
+
+    static constexpr inline auto option_declarations = make_option_declarations(
+        OptionDeclaration{"profile", "hot-percent", OptionDeclaration::Unsigned},
+        OptionDeclaration{"profile", "cold-percent", OptionDeclaration::Unsigned},
+        OptionDeclaration{"profile", "raise-hot", OptionDeclaration::Bool});
+
+public:
+    ProfileFilter(const Config & config, const clang::SourceManager & source_manager);
+
+    /// Whether the configuration has a profile
+    static bool isNeeded(const Config & config)
+    { return config.get_profile() != nullptr; }
+
+    /// Whether diagnostics in hot functions have raised severity ('profile.raise-hot', off by default)
+    bool shouldRaiseHot() const
+    { return m_raise_hot; }
+
+    /// Records function definitions of a top level declaration. Namespaces and classes are walked,
+    /// function bodies are not: local classes and lambdas belong to the enclosing function
+    void addFunctions(const clang::Decl * decl);
+
+    /// Weight of the function containing 'loc', nullopt if it's outside of function definitions
+    std::optional<Weight> getWeight(clang::SourceLocation loc);
+
+    /// Severity of diagnostics in hot functions: notes become warnings, warnings - errors
+    static clang::DiagnosticIDs::Level raiseLevel(clang::DiagnosticIDs::Level level);
+
+    /// ' [hot: 1234 samples, 5.6% of the profile]' suffix of a diagnostic
+    static std::string formatWeight(const Weight & weight);
+
+    /// The diagnostic of 'diag_id' with 'level', followed by the weight ('formatWeight') as its last argument.
+    /// The ID is created once per diagnostic and level, not per distinct weight
+    DiagnosticID getWeightedDiagID(clang::DiagnosticIDs & diagnostic_ids, DiagnosticID diag_id, clang::DiagnosticIDs::Level level);
+
+private:
+    struct FunctionRange
+    {
+        unsigned begin = 0;
+        unsigned end = 0;
+        std::uint64_t stack_samples = 0;
+        std::uint64_t line_samples = 0;
+    };
+
+    struct FileFunctions
+    {
+        std::vector<FunctionRange> ranges;
+        bool sorted = true;
+    };
+
+private:
+    void addFunction(const clang::FunctionDecl * decl);
+    std::uint64_t getSymbolSamples(const clang::FunctionDecl * decl) const;
+    std::uint64_t getLineSamples(clang::FileID file_id, unsigned first_line, unsigned last_line);
+    const std::vector<const Profile::LineSamples *> & getFileLineSamples(clang::FileID file_id);
+
+private:
+    const Profile & m_profile;
+    const clang::SourceManager & m_source_manager;
+    const unsigned m_hot_percent;
+    const unsigned m_cold_percent;
+    const bool m_raise_hot;
+    llvm::DenseMap<clang::FileID, FileFunctions> m_functions;
+    llvm::DenseMap<clang::FileID, std::vector<const Profile::LineSamples *>> m_file_lines;
+    llvm::DenseMap<std::pair<DiagnosticID, unsigned>, DiagnosticID> m_weighted_diag_ids;
+};
+
+} // namespace ica
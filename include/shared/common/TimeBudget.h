@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+
+namespace ica {
+
+/// Time the plugin may spend on a translation unit ('budget-ms=' argument).
+/// Only the time between 'start' and 'stop' calls is accounted, parsing isn't included
+class TimeBudget
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimeBudget(const std::chrono::milliseconds budget)
+        : m_budget(budget)
+        , m_limit(budget)
+    { }
+
+    void start()
+    { m_start = Clock::now(); }
+
+    void stop()
+    { m_spent += Clock::now() - m_start; }
+
+    bool isExceeded() const
+    { return m_spent > m_limit; }
+
+    /// Gives a tenth of the budget more, so skipping one check at a time leaves
+    /// the cheap ones running if the expensive ones were the reason of exceeding
+    void extend()
+    { m_limit += m_budget / 10; }
+
+    std::chrono::milliseconds getBudget() const
+    { return m_budget; }
+
+private:
+    const std::chrono::milliseconds m_budget;
+    Clock::duration m_limit;
+    Clock::duration m_spent{};
+    Clock::time_point m_start;
+};
+
+} // namespace ica
@@ -2,43 +2,123 @@
 
 #include "shared/common/Visitor.h"
 #include "shared/common/Config.h"
+#include "shared/common/LocationFilter.h"
 
 #include "clang/AST/AST.h"
 #include "clang/AST/ASTConsumer.h"
 
+#include "llvm/ADT/ArrayRef.h"
+
 #include <clang/AST/DeclCXX.h>
 #include <clang/AST/ExprCXX.h>
 #include <clang/AST/Stmt.h>
 #include <clang/AST/StmtCXX.h>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <string_view>
 #include <array>
+#include <vector>
 
 namespace ica {
 
+template<class ... Visitors>
+class UnitedVisitor;
+
+template <class T>
+struct IsUnitedVisitor : std::false_type {};
+
+template <class ... Visitors>
+struct IsUnitedVisitor<UnitedVisitor<Visitors...>> : std::true_type {};
+
 template<class ... Visitors>
 class UnitedVisitor : public clang::RecursiveASTVisitor<UnitedVisitor<Visitors...>>
 {
+    static constexpr inline unsigned checkpoint_interval = 1024;
+
 public:
 
     UnitedVisitor(clang::CompilerInstance & ci, const Config & config) :
         m_united_visitor(Visitors(ci, config)...),
-        m_should_visit_template_instantiations(std::apply([](auto & ... visitors)
-                {return ((visitors.isEnabled() && visitors.shouldVisitTemplateInstantiations()) || ...); }, m_united_visitor))
+        m_should_visit_template_instantiations(computeShouldVisitTemplateInstantiations()),
+        m_should_visit_decls_from_ast_file(computeShouldVisitDeclsFromASTFile())
+    {
+    }
+
+    /// Traverses the translation unit. Unless any enabled visitor needs declarations of PCH/modules,
+    /// only local top-level declarations are traversed, without loading the others from the AST file.
+    /// Instantiations of the skipped templates made by the translation unit ('ast_file_instantiations')
+    /// are traversed then, they can't be reached through their templates
+    void traverseTranslationUnit(clang::ASTContext & context, const llvm::ArrayRef<clang::Decl *> ast_file_instantiations)
+    {
+        auto * translation_unit = context.getTranslationUnitDecl();
+        if (!context.getExternalSource() || m_should_visit_decls_from_ast_file) {
+            for (auto * decl : translation_unit->decls()) {
+                traverseTopLevelDecl(decl);
+            }
+            return;
+        }
+
+        for (auto * decl : translation_unit->noload_decls()) {
+            traverseTopLevelDecl(decl);
+        }
+
+        for (auto * decl : ast_file_instantiations) {
+            if (m_should_visit_template_instantiations) {
+                this->TraverseDecl(decl);
+            }
+        }
+    }
+
+    bool TraverseDecl(clang::Decl * decl)
+    {
+        countCheckpointNode();
+        if (decl && decl->isFromASTFile() && !m_should_visit_decls_from_ast_file) {
+            return true;
+        }
+        // filtered files are pruned on namespace level, nested declarations are in the same file
+        if (m_location_filter && decl && decl->getDeclContext() && decl->getDeclContext()->isFileContext()
+                && !m_location_filter->shouldVisit(decl)) {
+            return true;
+        }
+        return clang::RecursiveASTVisitor<UnitedVisitor>::TraverseDecl(decl);
+    }
+
+    void setLocationFilter(LocationFilter * location_filter)
+    { m_location_filter = location_filter; }
+
+    void setDiagnosticLimiter(DiagnosticLimiter * diagnostic_limiter)
+    {
+        std::apply([diagnostic_limiter](auto & ... visitors)
+            { (visitors.setDiagnosticLimiter(diagnostic_limiter), ...); }, m_united_visitor);
+    }
+
+    void setProfileFilter(ProfileFilter * profile_filter)
     {
+        std::apply([profile_filter](auto & ... visitors)
+            { (visitors.setProfileFilter(profile_filter), ...); }, m_united_visitor);
+    }
+
+    void setEffectSummaries(EffectSummaries * effect_summaries)
+    {
+        std::apply([effect_summaries](auto & ... visitors)
+            { (visitors.setEffectSummaries(effect_summaries), ...); }, m_united_visitor);
     }
 
 // use arithmetic 'or' to avoid short-circuit of logical operator
 #define DEFINE_VISIT_METHOD(type) \
 bool Visit ## type(clang::type * expr) \
 { \
-    return std::apply([&expr](auto & ... visitors) \
-        { return ((visitors.isEnabled() && visitors.Visit ## type(expr)) | ...); }, m_united_visitor); \
+    return std::apply([this, &expr](auto & ... visitors) \
+        { return (callVisitor(visitors, [&expr](auto & visitor) { return visitor.Visit ## type(expr); }) | ...); }, m_united_visitor); \
 }
 
 DEFINE_VISIT_METHOD(CallExpr)
 DEFINE_VISIT_METHOD(ForStmt)
+DEFINE_VISIT_METHOD(IfStmt)
+DEFINE_VISIT_METHOD(ConditionalOperator)
 DEFINE_VISIT_METHOD(CompoundStmt)
 DEFINE_VISIT_METHOD(CXXConstCastExpr)
 DEFINE_VISIT_METHOD(CXXConstructExpr)
@@ -57,12 +137,20 @@ DEFINE_VISIT_METHOD(ReturnStmt)
 
 #undef DEFINE_VISIT_METHOD
 
+    /// Some visitors analyze the whole translation unit here, so the checkpoint is called before each of them
     void printDiagnostic(clang::ASTContext & context)
     {
-        std::apply([&context](auto & ... visitors)
+        std::apply([this, &context](auto & ... visitors)
             { (printVisitorDiagnostic(context, visitors), ...); }, m_united_visitor);
     }
 
+    void finishTranslationUnit(clang::ASTContext & context)
+    {
+        std::apply([this, &context](auto & ... visitors)
+            { (callVisitor(visitors, [&context](auto & visitor) { visitor.finishTranslationUnit(context); return true; }), ...); },
+            m_united_visitor);
+    }
+
     void setContext(clang::ASTContext & context)
     {
         std::apply([&context](auto & ... visitors)
@@ -72,15 +160,60 @@ DEFINE_VISIT_METHOD(ReturnStmt)
     bool shouldVisitTemplateInstantiations() const
     { return m_should_visit_template_instantiations; }
 
+    bool shouldVisitDeclsFromASTFile() const
+    { return m_should_visit_decls_from_ast_file; }
+
+    /// Skips visitors whose trigger names don't occur in the translation unit (yet)
+    void updateTriggered(const clang::IdentifierTable & identifiers)
+    {
+        std::apply([&identifiers](auto & ... visitors)
+            { (visitors.updateTriggered(identifiers), ...); }, m_united_visitor);
+        updateTraversalFlags();
+    }
+
+    /// Should be called once any visitor is enabled or disabled
+    void updateTraversalFlags()
+    {
+        m_should_visit_template_instantiations = computeShouldVisitTemplateInstantiations();
+        m_should_visit_decls_from_ast_file = computeShouldVisitDeclsFromASTFile();
+    }
+
+    /// Starts accounting time spent by every visitor (see VisitorBase::getSpentTime)
+    void enableTiming()
+    {
+        m_timing = true;
+        std::apply([](auto & ... visitors)
+            { (enableVisitorTiming(visitors), ...); }, m_united_visitor);
+    }
+
+    /// Adds the options read by the visitors, including the ones of nested united visitors, to 'result'
+    static void collectOptionDeclarations(std::vector<OptionDeclaration> & result)
+    { (Visitors::collectOptionDeclarations(result), ...); }
+
+    /// Adds enabled visitors, including the ones of nested united visitors, to 'result'
+    void collectEnabledVisitors(std::vector<VisitorBase *> & result)
+    {
+        std::apply([&result](auto & ... visitors)
+            { (collectEnabledVisitor(visitors, result), ...); }, m_united_visitor);
+    }
+
+    /// 'checkpoint' is called every 'checkpoint_interval' traversed nodes and before the diagnostic
+    /// of every visitor is printed, e.g. to check the time budget in the middle of a large declaration
+    void setCheckpoint(std::function<void()> checkpoint)
+    { m_checkpoint = std::move(checkpoint); }
+
     bool dataTraverseStmtPre(clang::Stmt * s) // TODO: handle case when a visitor returns false
     {
-        std::apply([&s](auto & ... visitors){ ((visitors.isEnabled() && visitors.dataTraverseStmtPre(s)), ...); }, m_united_visitor);
+        countCheckpointNode();
+        std::apply([this, &s](auto & ... visitors)
+            { (callVisitor(visitors, [&s](auto & visitor) { return visitor.dataTraverseStmtPre(s); }), ...); }, m_united_visitor);
         return true;
     }
 
     bool dataTraverseStmtPost(clang::Stmt * s) // TODO: handle case when a visitor returns false
     {
-        std::apply([&s](auto & ... visitors){ ((visitors.isEnabled() && visitors.dataTraverseStmtPost(s)), ...); }, m_united_visitor);
+        std::apply([this, &s](auto & ... visitors)
+            { (callVisitor(visitors, [&s](auto & visitor) { return visitor.dataTraverseStmtPost(s); }), ...); }, m_united_visitor);
         return true;
     }
 
@@ -97,12 +230,67 @@ public:
 
 private:
 
+    void traverseTopLevelDecl(clang::Decl * decl)
+    {
+        // same as RecursiveASTVisitor does for children of a DeclContext:
+        // blocks, captured statements and lambda classes are traversed through their expressions
+        if (clang::isa<clang::BlockDecl>(decl) || clang::isa<clang::CapturedDecl>(decl)) {
+            return;
+        }
+        if (const auto * record = clang::dyn_cast<clang::CXXRecordDecl>(decl); record && record->isLambda()) {
+            return;
+        }
+
+        this->TraverseDecl(decl);
+    }
+
+    void countCheckpointNode()
+    {
+        if (m_checkpoint && ++m_checkpoint_nodes == checkpoint_interval) {
+            m_checkpoint_nodes = 0;
+            m_checkpoint();
+        }
+    }
+
+    /// Calls 'call' for an enabled visitor. Nested united visitors account time of their visitors themselves
+    template <class Visitor, class Call>
+    bool callVisitor(Visitor & visitor, Call && call)
+    {
+        if (!visitor.isEnabled()) {
+            return false;
+        }
+
+        if constexpr (!IsUnitedVisitor<Visitor>::value) {
+            if (m_timing) {
+                const auto start = std::chrono::steady_clock::now();
+                const bool result = call(visitor);
+                visitor.addSpentTime(std::chrono::steady_clock::now() - start);
+                return result;
+            }
+        }
+
+        return call(visitor);
+    }
+
+    bool computeShouldVisitTemplateInstantiations() const
+    {
+        return std::apply([](const auto & ... visitors)
+            { return ((visitors.isEnabled() && visitors.shouldVisitTemplateInstantiations()) || ...); }, m_united_visitor);
+    }
+
+    bool computeShouldVisitDeclsFromASTFile() const
+    {
+        return std::apply([](const auto & ... visitors)
+            { return ((visitors.isEnabled() && visitors.shouldVisitDeclsFromASTFile()) || ...); }, m_united_visitor);
+    }
+
     template <class Visitor>
-    static void printVisitorDiagnostic(clang::ASTContext & context, Visitor & visitor)
+    void printVisitorDiagnostic(clang::ASTContext & context, Visitor & visitor)
     {
-        if (visitor.isEnabled()) {
-            visitor.printDiagnostic(context);
+        if (m_checkpoint && visitor.isEnabled()) {
+            m_checkpoint();
         }
+        callVisitor(visitor, [&context](auto & visitor) { visitor.printDiagnostic(context); return true; });
     }
 
     template <class Visitor>
@@ -120,8 +308,31 @@ private:
         }
     }
 
+    template <class Visitor>
+    static void enableVisitorTiming(Visitor & visitor)
+    {
+        if constexpr (IsUnitedVisitor<Visitor>::value) {
+            visitor.enableTiming();
+        }
+    }
+
+    template <class Visitor>
+    static void collectEnabledVisitor(Visitor & visitor, std::vector<VisitorBase *> & result)
+    {
+        if constexpr (IsUnitedVisitor<Visitor>::value) {
+            visitor.collectEnabledVisitors(result);
+        } else if (visitor.isEnabled()) {
+            result.push_back(&visitor);
+        }
+    }
+
     std::tuple<Visitors...> m_united_visitor;
     bool m_should_visit_template_instantiations;
+    bool m_should_visit_decls_from_ast_file;
+    bool m_timing = false;
+    std::function<void()> m_checkpoint;
+    unsigned m_checkpoint_nodes = 0;
+    LocationFilter * m_location_filter = nullptr;
 };
 
 } // namespace ica
@@ -8,10 +8,23 @@
 #include "shared/common/Common.h"
 #include "shared/common/Checks.h"
 #include "shared/common/Config.h"
+#include "shared/common/DiagnosticLimiter.h"
 #include "shared/common/DiagnosticsBuilder.h"
+#include "shared/common/EffectSummaries.h"
+#include "shared/common/Options.h"
+#include "shared/common/ProfileFilter.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace ica {
 
@@ -21,6 +34,39 @@ constexpr auto make_check_names(const Ts & ... ts)
     return std::array<std::string_view, sizeof...(Ts)>{ std::string_view(ts)... };
 }
 
+/// Identifiers without which none of the visitor checks can fire (e.g. called method names)
+template <class ... Ts>
+constexpr auto make_trigger_names(const Ts & ... ts)
+{
+    return make_check_names(ts...);
+}
+
+/// Performance checks of the visitor: the cost of their findings is proportional to how often the code runs,
+/// so a profile weighs them. Findings of the other checks matter in cold code as well
+template <class ... Ts>
+constexpr auto make_weighted_check_names(const Ts & ... ts)
+{
+    return make_check_names(ts...);
+}
+
+template <class VisitorImpl, class = void>
+struct HasTriggerNames : std::false_type {};
+
+template <class VisitorImpl>
+struct HasTriggerNames<VisitorImpl, std::void_t<decltype(VisitorImpl::trigger_names)>> : std::true_type {};
+
+template <class VisitorImpl, class = void>
+struct HasOptionDeclarations : std::false_type {};
+
+template <class VisitorImpl>
+struct HasOptionDeclarations<VisitorImpl, std::void_t<decltype(VisitorImpl::option_declarations)>> : std::true_type {};
+
+template <class VisitorImpl, class = void>
+struct HasWeightedCheckNames : std::false_type {};
+
+template <class VisitorImpl>
+struct HasWeightedCheckNames<VisitorImpl, std::void_t<decltype(VisitorImpl::weighted_check_names)>> : std::true_type {};
+
 
 class VisitorBase
 {
@@ -51,9 +97,12 @@ private:
 
 public:
     template <class CheckNames>
-    explicit VisitorBase(clang::CompilerInstance & ci, const Config & config, const CheckNames & check_names)
+    explicit VisitorBase(clang::CompilerInstance & ci, const Config & config, const CheckNames & check_names,
+                         const llvm::ArrayRef<std::string_view> weighted_check_names)
         : m_diag(ci.getDiagnostics())
         , m_config(config)
+        , m_check_names(std::data(check_names), std::size(check_names))
+        , m_weighted_check_names(weighted_check_names)
         , m_enabled(computeEnabled(m_config.get_checks(), check_names))
     {
     }
@@ -64,8 +113,50 @@ public:
     void resetContext()
     { this->m_context = nullptr; }
 
+    void setDiagnosticLimiter(DiagnosticLimiter * diagnostic_limiter)
+    { m_diagnostic_limiter = diagnostic_limiter; }
+
+    void setProfileFilter(ProfileFilter * profile_filter)
+    { m_profile_filter = profile_filter; }
+
+    void setEffectSummaries(EffectSummaries * effect_summaries)
+    { m_effect_summaries = effect_summaries; }
+
     bool isEnabled() const
-    { return m_enabled; }
+    { return m_enabled && m_triggered && !m_skipped; }
+
+    /// Disables the visitor for the rest of the translation unit
+    void skip()
+    { m_skipped = true; }
+
+    /// Names of the visitor checks enabled by the configuration
+    std::vector<std::string_view> getEnabledCheckNames() const
+    {
+        std::vector<std::string_view> result;
+        for (const auto check_name : m_check_names) {
+            if (getCheck(check_name)) {
+                result.push_back(check_name);
+            }
+        }
+        return result;
+    }
+
+    /// Time spent in the visitor callbacks, accounted only if the united visitor has timing enabled
+    std::chrono::steady_clock::duration getSpentTime() const
+    { return m_spent_time; }
+
+    void addSpentTime(const std::chrono::steady_clock::duration time)
+    { m_spent_time += time; }
+
+    /// Declarations loaded from a PCH or a module are skipped by default:
+    /// they belong to other translation units and traversing them forces deserialization
+    bool shouldVisitDeclsFromASTFile() const
+    { return false; }
+
+    /// Called once the whole translation unit is parsed: a top level declaration visitor reports here
+    /// what depends on the declarations after the checked one
+    void finishTranslationUnit(clang::ASTContext &)
+    {}
 
 protected:
     clang::ASTContext & getContext()
@@ -80,12 +171,27 @@ protected:
     const clang::SourceManager & getSM() const
     { return m_context->getSourceManager(); }
 
+    /// Effect summaries and the call graph of the translation unit, shared by the visitors
+    EffectSummaries & getEffectSummaries()
+    { return *m_effect_summaries; }
+
 protected:
-    auto report(const DiagnosticID diag_id)
-    { return ica::report(m_diag, diag_id); }
+    DiagnosticBuilder report(DiagnosticID diag_id)
+    {
+        if (!filterReport(clang::SourceLocation(), diag_id)) {
+            return suppressedReport();
+        }
+        return ica::report(m_diag, diag_id);
+    }
 
-    auto report(const clang::SourceLocation loc, const DiagnosticID diag_id)
-    { return ica::report(m_diag, loc, diag_id); }
+    DiagnosticBuilder report(const clang::SourceLocation loc, DiagnosticID diag_id)
+    {
+        std::optional<std::string> weight;
+        if (!filterReport(loc, diag_id, &weight)) {
+            return suppressedReport();
+        }
+        return ica::report(m_diag, loc, diag_id, std::move(weight));
+    }
 
     DiagnosticID getCustomDiagID(const std::string_view check_name, std::string format_string)
     {
@@ -95,7 +201,11 @@ protected:
         }
 
         format_string = appendCheckName(std::move(format_string), check_name);
-        return m_diag.getDiagnosticIDs()->getCustomDiagID(check, format_string);
+        const auto diag_id = m_diag.getDiagnosticIDs()->getCustomDiagID(check, format_string);
+        const bool weighted = std::find(m_weighted_check_names.begin(), m_weighted_check_names.end(), check_name)
+            != m_weighted_check_names.end();
+        m_diag_checks[diag_id] = CheckDiagnostic{check_name, check, weighted};
+        return diag_id;
     }
 
     DiagnosticID getCustomDiagID(clang::DiagnosticIDs::Level level, llvm::StringRef format_string)
@@ -104,11 +214,70 @@ protected:
     Check getCheck(const std::string_view check) const
     { return m_config.get_checks()[check]; }
 
+    void setTriggered(const bool triggered)
+    { m_triggered = triggered; }
+
+private:
+    struct CheckDiagnostic
+    {
+        std::string_view check_name;
+        clang::DiagnosticIDs::Level level;
+        bool weighted = false;
+    };
+
+    /// Decides whether the diagnostic is reported. With a profile, 'diag_id' of a performance check is replaced
+    /// by the same diagnostic followed by the sample weight ('weight_string') and, in hot functions, optionally raised severity
+    bool filterReport(const clang::SourceLocation loc, DiagnosticID & diag_id, std::optional<std::string> * weight_string = nullptr)
+    {
+        // diagnostics without a check are notes, they follow the diagnostic they're attached to
+        const auto it = m_diag_checks.find(diag_id);
+        if (it == m_diag_checks.end()) {
+            return !m_last_suppressed;
+        }
+
+        const auto & check_diagnostic = it->second;
+        const auto weight = m_profile_filter && check_diagnostic.weighted && weight_string
+            ? m_profile_filter->getWeight(loc)
+            : std::nullopt;
+
+        m_last_suppressed = (weight && weight->hotness == ProfileFilter::Hotness::Cold)
+            || (m_diagnostic_limiter && !m_diagnostic_limiter->shouldReport(loc, check_diagnostic.check_name));
+        if (m_last_suppressed) {
+            return false;
+        }
+
+        if (weight) {
+            const auto level = weight->hotness == ProfileFilter::Hotness::Hot && m_profile_filter->shouldRaiseHot()
+                ? ProfileFilter::raiseLevel(check_diagnostic.level)
+                : check_diagnostic.level;
+            diag_id = m_profile_filter->getWeightedDiagID(*m_diag.getDiagnosticIDs(), diag_id, level);
+            *weight_string = ProfileFilter::formatWeight(*weight);
+        }
+        return true;
+    }
+
+protected:
+    /// Value of the 'check_name.option' tunable, 'default_value' if it isn't set.
+    /// The option must be listed in 'option_declarations' of the visitor, otherwise setting it is an error
+    template <class T>
+    T getOption(const std::string_view check_name, const std::string_view option, T default_value) const
+    { return m_config.get_options().get<T>(check_name, option).value_or(std::move(default_value)); }
+
 private:
     clang::DiagnosticsEngine & m_diag;
     const Config & m_config;
     clang::ASTContext * m_context = nullptr;
+    llvm::ArrayRef<std::string_view> m_check_names;
+    llvm::ArrayRef<std::string_view> m_weighted_check_names;
+    DiagnosticLimiter * m_diagnostic_limiter = nullptr;
+    ProfileFilter * m_profile_filter = nullptr;
+    EffectSummaries * m_effect_summaries = nullptr;
+    llvm::SmallDenseMap<DiagnosticID, CheckDiagnostic, 4> m_diag_checks;
+    std::chrono::steady_clock::duration m_spent_time{};
     bool m_enabled = false;
+    bool m_triggered = true;
+    bool m_skipped = false;
+    bool m_last_suppressed = false;
 };
 
 
@@ -120,9 +289,52 @@ class Visitor
 {
 public:
     explicit Visitor(clang::CompilerInstance & ci, const Config & config)
-        : VisitorBase(ci, config, VisitorImpl::check_names)
+        : VisitorBase(ci, config, VisitorImpl::check_names, getWeightedCheckNames())
     {
     }
+
+    /// Adds the options read by the visitor checks ('option_declarations') to 'result'
+    static void collectOptionDeclarations(std::vector<OptionDeclaration> & result)
+    {
+        if constexpr (HasOptionDeclarations<VisitorImpl>::value) {
+            result.insert(result.end(), std::begin(VisitorImpl::option_declarations), std::end(VisitorImpl::option_declarations));
+        }
+    }
+
+    /// Disables the visitor while none of its 'trigger_names' is known to the preprocessor.
+    /// Identifiers only get added while parsing goes on, so once a name is found,
+    /// the visitor stays enabled for the rest of the translation unit
+    void updateTriggered(const clang::IdentifierTable & identifiers)
+    {
+        if constexpr (HasTriggerNames<VisitorImpl>::value) {
+            if (m_trigger_found) {
+                return;
+            }
+
+            // identifiers of a PCH or a module are loaded lazily, so they can't be looked up
+            const auto is_known = [&identifiers] (const std::string_view name) {
+                return identifiers.getExternalIdentifierLookup() != nullptr
+                    || identifiers.find(llvm::StringRef(name.data(), name.size())) != identifiers.end();
+            };
+
+            m_trigger_found = std::any_of(std::begin(VisitorImpl::trigger_names), std::end(VisitorImpl::trigger_names),
+                    is_known);
+            setTriggered(m_trigger_found);
+        }
+    }
+
+private:
+    static llvm::ArrayRef<std::string_view> getWeightedCheckNames()
+    {
+        if constexpr (HasWeightedCheckNames<VisitorImpl>::value) {
+            return VisitorImpl::weighted_check_names;
+        } else {
+            return {};
+        }
+    }
+
+private:
+    bool m_trigger_found = false;
 };
 
 } // namespace ica
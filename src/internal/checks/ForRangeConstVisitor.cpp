@@ -5,16 +5,19 @@
 
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclTemplate.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
 #include "clang/AST/OperationKinds.h"
 #include "clang/AST/Stmt.h"
 #include "clang/AST/StmtCXX.h"
+#include "clang/AST/TemplateBase.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/OperatorKinds.h"
 #include "clang/Basic/Specifiers.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Lex/Lexer.h"
 
 #include <algorithm>
 #include <numeric>
@@ -56,6 +59,124 @@ const clang::Expr * nullIfNotConsidered(const clang::Expr * expr)
     return is_considered ? expr : nullptr;
 }
 
+/// Copy constructor is available. If it isn't declared yet, it's implicit one, which is deleted
+/// along with user declared move operations or for a non-copyable member
+bool isCopyable(const clang::CXXRecordDecl * record)
+{
+    for (const auto * ctor : record->ctors()) {
+        if (ctor->isCopyConstructor()) {
+            return !ctor->isDeleted();
+        }
+    }
+
+    if (record->hasUserDeclaredMoveConstructor() || record->hasUserDeclaredMoveAssignment()) {
+        return false;
+    }
+    for (const auto & base : record->bases()) {
+        if (const auto * base_record = base.getType()->getAsCXXRecordDecl(); base_record && !isCopyable(base_record)) {
+            return false;
+        }
+    }
+    for (const auto * field : record->fields()) {
+        if (field->getType()->isRValueReferenceType()) {
+            return false;
+        }
+        const auto * field_record = field->getType()->getBaseElementTypeUnsafe()->getAsCXXRecordDecl();
+        if (field_record && field_record->hasDefinition() && !isCopyable(field_record->getDefinition())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Loop variable is copy constructed from the element, not converted or initialized by a returned value
+bool isElementCopy(const clang::VarDecl * loop_var)
+{
+    const auto * init = loop_var->getInit();
+    const auto * construct = init ? clang::dyn_cast<clang::CXXConstructExpr>(init->IgnoreImplicit()) : nullptr;
+    return construct && construct->getConstructor()->isCopyConstructor();
+}
+
+/// Element, which is converted to a temporary of class type to bind the reference loop variable to,
+/// null if the loop variable is bound to the element itself (or to the element returned by value)
+const clang::Expr * getConvertedElement(const clang::VarDecl * loop_var)
+{
+    if (!loop_var->getType()->isReferenceType()) {
+        return nullptr;
+    }
+
+    const auto * init = loop_var->getInit();
+    if (const auto * full_expr = clang::dyn_cast_or_null<clang::FullExpr>(init)) {
+        init = full_expr->getSubExpr();
+    }
+    const auto * temporary = clang::dyn_cast_or_null<clang::MaterializeTemporaryExpr>(init);
+    if (!temporary || !temporary->getType()->getAsCXXRecordDecl()) {
+        return nullptr;
+    }
+
+    const auto * source = temporary->getSubExpr()->IgnoreImplicit();
+    if (const auto * construct = clang::dyn_cast<clang::CXXConstructExpr>(source); construct && construct->getNumArgs() > 0) {
+        return construct->getArg(0);
+    }
+    if (const auto * member_call = clang::dyn_cast<clang::CXXMemberCallExpr>(source);
+            member_call && clang::isa_and_nonnull<clang::CXXConversionDecl>(member_call->getMethodDecl())) {
+        return member_call->getImplicitObjectArgument();
+    }
+    return nullptr;
+}
+
+/// Whether a temporary of the type owns nothing: it's trivially copied and destroyed (e.g. 'std::string_view')
+bool isCheapTemporary(const clang::QualType & type)
+{
+    const auto * record = type->getAsCXXRecordDecl();
+    return !record || (record->hasTrivialCopyConstructor() && record->hasTrivialDestructor());
+}
+
+/// Whether the types are specializations of the same class template, whose arguments differ in cv-qualifiers only,
+/// e.g. 'std::pair<std::string, int>' and 'std::pair<const std::string, int>' of a map element
+bool differInArgQualifiersOnly(const clang::QualType & type, const clang::QualType & other)
+{
+    const auto * spec = clang::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(type->getAsCXXRecordDecl());
+    const auto * other_spec = clang::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(other->getAsCXXRecordDecl());
+    if (!spec || !other_spec || spec == other_spec
+            || spec->getSpecializedTemplate()->getCanonicalDecl() != other_spec->getSpecializedTemplate()->getCanonicalDecl()) {
+        return false;
+    }
+
+    const auto & args = spec->getTemplateArgs();
+    const auto & other_args = other_spec->getTemplateArgs();
+    if (args.size() != other_args.size()) {
+        return false;
+    }
+    for (unsigned i = 0; i < args.size(); ++i) {
+        if (args[i].getKind() == clang::TemplateArgument::Type && other_args[i].getKind() == clang::TemplateArgument::Type) {
+            if (args[i].getAsType().getCanonicalType().getUnqualifiedType() != other_args[i].getAsType().getCanonicalType().getUnqualifiedType()) {
+                return false;
+            }
+        } else if (!args[i].structurallyEquals(other_args[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Parameter passed by value, which is the returned value: it's moved, not copied
+const clang::ParmVarDecl * getReturnedByValueParm(const clang::Expr * ret_value)
+{
+    if (!ret_value) {
+        return nullptr;
+    }
+
+    ret_value = ret_value->IgnoreImplicit();
+    if (const auto * construct = clang::dyn_cast<clang::CXXConstructExpr>(ret_value); construct && construct->getNumArgs() == 1) {
+        ret_value = construct->getArg(0);
+    }
+
+    const auto * decl_ref = clang::dyn_cast<clang::DeclRefExpr>(ret_value->IgnoreParenImpCasts());
+    const auto * parm = decl_ref ? clang::dyn_cast<clang::ParmVarDecl>(decl_ref->getDecl()) : nullptr;
+    return parm && !parm->getType()->isReferenceType() ? parm : nullptr;
+}
+
 } // namespace
 
 namespace ica {
@@ -97,6 +218,13 @@ ForRangeConstVisitor::ForRangeConstVisitor(clang::CompilerInstance & ci, const C
     m_for_range_const_id = getCustomDiagID(for_range_const, "'const' should be specified explicitly for variable in for-range loop");
     m_const_param_id = getCustomDiagID(const_param, "%0 can have 'const' qualifier");
     m_const_rvalue_id = getCustomDiagID(const_param, "%0 is got as rvalue-reference, but never modified");
+    m_pass_by_value_id = getCustomDiagID(expensive_pass_by_value, "%0 is expensive to copy, but it's only read, consider passing it by 'const' reference");
+    m_min_bytes = getOption<std::uint64_t>(expensive_pass_by_value, "min-bytes", default_min_bytes);
+    m_range_for_copy_id = getCustomDiagID(range_for_copy, "loop variable copies every element of the range, consider binding it by 'const' reference");
+    m_range_for_copy_min_bytes = getOption<std::uint64_t>(range_for_copy, "min-bytes", default_min_bytes);
+    m_range_for_temporary_id = getCustomDiagID(range_for_temporary, "loop variable is bound to a temporary '%0' converted from '%1' on every iteration");
+    m_range_for_hidden_copy_id = getCustomDiagID(range_for_temporary, "loop variable copies every element: '%0' differs from the element type '%1' "
+                                                                      "in qualifiers only, consider 'const auto &'");
 }
 
 ForRangeConstVisitor::ForRangeConstVisitor(ForRangeConstVisitor &&) = default;
@@ -123,13 +251,19 @@ bool ForRangeConstVisitor::VisitCXXForRangeStmt(clang::CXXForRangeStmt *for_stmt
         }
     }
 
+    if (getCheck(range_for_temporary) && !for_stmt->getRangeInit()->isInstantiationDependent()) {
+        checkLoopVarTemporary(for_stmt);
+    }
+
     auto loop_var = for_stmt->getLoopVariable();
     auto ref_info = getRefTypeInfo(loop_var->getType());
     if (ref_info.is_ref && !ref_info.is_const) {
         removeCheckedVar(extractDeclRef(for_stmt->getRangeInit()));
     }
 
-    if (loop_var->getType()->isPointerType() || ref_info.is_const) {
+    // 'const' copies are still copies
+    const bool is_const_copy = ref_info.is_const && !ref_info.is_ref && getCheck(range_for_copy);
+    if (loop_var->getType()->isPointerType() || (ref_info.is_const && !is_const_copy)) {
         return true; // ignore already const variables or pointers
     }
 
@@ -210,6 +344,7 @@ bool ForRangeConstVisitor::VisitFunctionDecl(clang::FunctionDecl * func_decl)
     };
 
     const auto * body = func_decl->getBody();
+    const bool check_by_value = getCheck(expensive_pass_by_value);
     uint parm_num = 0;
     for (const auto * parm : func_decl->parameters()) {
         if (parm_num > 255) {
@@ -217,7 +352,11 @@ bool ForRangeConstVisitor::VisitFunctionDecl(clang::FunctionDecl * func_decl)
                     func_decl->getNameInfo().getAsString() <<
                     ". for-range-const and const-param may have problems\n";
         }
-        if (not_templated(parm_num) && !isConstType(parm->getType()) && parm->getType()->isReferenceType() && !inits_ref(parm)) {
+        const bool is_not_templated = not_templated(parm_num);
+        if (is_not_templated && !isConstType(parm->getType()) && parm->getType()->isReferenceType() && !inits_ref(parm)) {
+            m_checked_vars.emplace(body, parm);
+        } else if (check_by_value && is_not_templated && !parm->getType()->isReferenceType() && isExpensiveToCopy(parm->getType(), m_min_bytes)) {
+            // the same as a reference parameter: the check fails as soon as the parameter is modified or moved
             m_checked_vars.emplace(body, parm);
         }
         ++parm_num;
@@ -264,6 +403,12 @@ bool ForRangeConstVisitor::VisitCXXMemberCallExpr(clang::CXXMemberCallExpr *memb
 
 bool ForRangeConstVisitor::VisitCallExpr(clang::CallExpr *call)
 {
+    if (getCheck(expensive_pass_by_value)) {
+        if (const auto * callee_ref = clang::dyn_cast<clang::DeclRefExpr>(call->getCallee()->IgnoreParenImpCasts())) {
+            m_callee_refs.insert(callee_ref);
+        }
+    }
+
     if (m_checked_vars.empty()) {
         return true;
     }
@@ -300,7 +445,18 @@ bool ForRangeConstVisitor::VisitCallExpr(clang::CallExpr *call)
     return true;
 }
 
+bool ForRangeConstVisitor::VisitDeclRefExpr(clang::DeclRefExpr * decl_ref)
+{
+    // the callee is visited after its call
+    if (!getCheck(expensive_pass_by_value) || m_callee_refs.erase(decl_ref) != 0) {
+        return true;
+    }
 
+    if (const auto * function = clang::dyn_cast<clang::FunctionDecl>(decl_ref->getDecl())) {
+        m_referenced_functions.insert(function->getCanonicalDecl());
+    }
+    return true;
+}
 
 bool ForRangeConstVisitor::VisitBinaryOperator(clang::BinaryOperator * bin_op)
 {
@@ -379,6 +535,9 @@ bool ForRangeConstVisitor::VisitReturnStmt(clang::ReturnStmt *ret_stmt)
     if (isMutRef(curr_ret_type)) {
         addMutRefProducer(ret_stmt->getRetValue(), nullptr);
     }
+    if (const auto * parm = getReturnedByValueParm(ret_stmt->getRetValue())) {
+        m_checked_vars.get<Referred>().erase(parm);
+    }
     return true;
 }
 
@@ -386,13 +545,22 @@ bool ForRangeConstVisitor::dataTraverseStmtPost(clang::Stmt *stmt)
 {
     if (auto [begin, end] = m_checked_vars.get<Scope>().equal_range(stmt); begin != end && begin->scope == stmt) {
         if (const auto * for_stmt = clang::dyn_cast<clang::CXXForRangeStmt>(stmt)) {
-            if (getCheck(for_range_const)) {
-                report(for_stmt->getLoopVariable()->getTypeSpecStartLoc(), m_for_range_const_id);
+            // a copy is worse than missing 'const', and the fix of the copy adds 'const' as well
+            const auto * loop_var = for_stmt->getLoopVariable();
+            if (getCheck(range_for_copy) && isElementCopy(loop_var) && isExpensiveToCopy(loop_var->getType(), m_range_for_copy_min_bytes)) {
+                reportLoopVarCopy(for_stmt);
+            } else if (getCheck(for_range_const) && !isConstType(loop_var->getType())) {
+                report(loop_var->getTypeSpecStartLoc(), m_for_range_const_id);
             }
-        } else if (getCheck(const_param)) {
+        } else {
             std::for_each(begin, end, [this](const auto & checked_entry) {
-                if (checked_entry.isReferred()) {
-                    const clang::ValueDecl * parm = checked_entry.referred;
+                if (!checked_entry.isReferred()) {
+                    return;
+                }
+                const clang::ValueDecl * parm = checked_entry.referred;
+                if (!parm->getType()->isReferenceType()) {
+                    reportPassByValue(clang::cast<clang::ParmVarDecl>(parm));
+                } else if (getCheck(const_param)) {
                     report(parm->getBeginLoc(), parm->getType()->isRValueReferenceType() ? m_const_rvalue_id : m_const_param_id)
                         .AddValue(parm);
                 }
@@ -510,6 +678,138 @@ bool ForRangeConstVisitor::isMutRef(const clang::QualType & type)
     return ref_type_info.is_ref && !ref_type_info.is_const;
 }
 
+bool ForRangeConstVisitor::isExpensiveToCopy(const clang::QualType & type, const std::uint64_t min_bytes)
+{
+    if (type->isDependentType() || type->isIncompleteType()) {
+        return false;
+    }
+
+    const auto * record = type->getAsCXXRecordDecl();
+    if (!record || !record->hasDefinition() || !isCopyable(record->getDefinition())) {
+        return false;
+    }
+
+    return !type.isTriviallyCopyableType(getContext())
+        || static_cast<std::uint64_t>(getContext().getTypeSizeInChars(type).getQuantity()) >= min_bytes;
+}
+
+void ForRangeConstVisitor::reportPassByValue(const clang::ParmVarDecl * parm)
+{
+    const auto * func_decl = clang::dyn_cast<clang::FunctionDecl>(parm->getDeclContext());
+    const auto * type_info = parm->getTypeSourceInfo();
+    const auto type_range = type_info ? type_info->getTypeLoc().getSourceRange() : clang::SourceRange();
+
+    // every declaration has to be changed, so only a single declaration is fixed automatically
+    const bool can_fix = func_decl && func_decl->isFirstDecl() && func_decl->getMostRecentDecl() == func_decl
+        && type_range.isValid() && !type_range.getBegin().isMacroID() && !type_range.getEnd().isMacroID();
+    if (!can_fix) {
+        report(parm->getBeginLoc(), m_pass_by_value_id)
+            .AddValue(parm);
+        return;
+    }
+
+    m_fixable_by_value_parms.push_back(parm);
+}
+
+void ForRangeConstVisitor::fixPassByValue(const clang::ParmVarDecl * parm)
+{
+    const auto type_range = parm->getTypeSourceInfo()->getTypeLoc().getSourceRange();
+    const auto type_end = clang::Lexer::getLocForEndOfToken(type_range.getEnd(), 0, getSM(), getContext().getLangOpts());
+    if (parm->getType().isConstQualified()) {
+        report(parm->getBeginLoc(), m_pass_by_value_id)
+            .AddValue(parm)
+            .AddFixItHint(clang::FixItHint::CreateInsertion(type_end, " &"));
+    } else {
+        report(parm->getBeginLoc(), m_pass_by_value_id)
+            .AddValue(parm)
+            .AddFixItHint(clang::FixItHint::CreateInsertion(type_range.getBegin(), "const "))
+            .AddFixItHint(clang::FixItHint::CreateInsertion(type_end, " &"));
+    }
+}
+
+void ForRangeConstVisitor::finishTranslationUnit(clang::ASTContext &)
+{
+    // changing the signature of a function, whose address is taken, breaks the code which stores it,
+    // as well as the one of a function redeclared after its definition
+    for (const auto * parm : m_fixable_by_value_parms) {
+        const auto * func_decl = clang::cast<clang::FunctionDecl>(parm->getDeclContext());
+        if (m_referenced_functions.count(func_decl->getCanonicalDecl()) != 0 || func_decl->getMostRecentDecl() != func_decl) {
+            report(parm->getBeginLoc(), m_pass_by_value_id)
+                .AddValue(parm);
+        } else {
+            fixPassByValue(parm);
+        }
+    }
+
+    m_fixable_by_value_parms.clear();
+    m_callee_refs.clear();
+    m_referenced_functions.clear();
+}
+
+void ForRangeConstVisitor::reportLoopVarCopy(const clang::CXXForRangeStmt * for_stmt)
+{
+    const auto * loop_var = for_stmt->getLoopVariable();
+    const auto * type_info = loop_var->getTypeSourceInfo();
+    const auto type_range = type_info ? type_info->getTypeLoc().getSourceRange() : clang::SourceRange();
+
+    if (type_range.isInvalid() || type_range.getBegin().isMacroID() || type_range.getEnd().isMacroID()) {
+        report(loop_var->getTypeSpecStartLoc(), m_range_for_copy_id);
+        return;
+    }
+
+    const auto type_end = clang::Lexer::getLocForEndOfToken(type_range.getEnd(), 0, getSM(), getContext().getLangOpts());
+    if (isConstType(loop_var->getType())) {
+        report(loop_var->getTypeSpecStartLoc(), m_range_for_copy_id)
+            .AddFixItHint(clang::FixItHint::CreateInsertion(type_end, " &"));
+    } else {
+        report(loop_var->getTypeSpecStartLoc(), m_range_for_copy_id)
+            .AddFixItHint(clang::FixItHint::CreateInsertion(type_range.getBegin(), "const "))
+            .AddFixItHint(clang::FixItHint::CreateInsertion(type_end, " &"));
+    }
+}
+
+void ForRangeConstVisitor::checkLoopVarTemporary(const clang::CXXForRangeStmt * for_stmt)
+{
+    const auto * loop_var = for_stmt->getLoopVariable();
+    const auto * element = getConvertedElement(loop_var);
+    if (!element) {
+        return;
+    }
+
+    const auto var_type = loop_var->getType().getNonReferenceType().getCanonicalType().getUnqualifiedType();
+    const auto element_type = element->getType().getCanonicalType().getUnqualifiedType();
+    const auto & policy = getContext().getPrintingPolicy();
+
+    if (!differInArgQualifiersOnly(var_type, element_type)) {
+        // a conversion to a cheap type (e.g. 'std::string_view') is rather intended
+        if (!isCheapTemporary(var_type)) {
+            report(loop_var->getTypeSpecStartLoc(), m_range_for_temporary_id)
+                .AddValue(var_type.getAsString(policy))
+                .AddValue(element_type.getAsString(policy));
+        }
+        return;
+    }
+
+    const auto * type_info = loop_var->getTypeSourceInfo();
+    const auto type_range = type_info ? type_info->getTypeLoc().getSourceRange() : clang::SourceRange();
+
+    // 'const' reference only: the loop body may modify the temporary bound to a non-const one
+    const bool can_fix = loop_var->getType().getNonReferenceType().isConstQualified()
+        && type_range.isValid() && !loop_var->getBeginLoc().isMacroID() && !type_range.getEnd().isMacroID();
+    if (!can_fix) {
+        report(loop_var->getTypeSpecStartLoc(), m_range_for_hidden_copy_id)
+            .AddValue(var_type.getAsString(policy))
+            .AddValue(element_type.getAsString(policy));
+        return;
+    }
+
+    const auto type_end = clang::Lexer::getLocForEndOfToken(type_range.getEnd(), 0, getSM(), getContext().getLangOpts());
+    report(loop_var->getTypeSpecStartLoc(), m_range_for_hidden_copy_id)
+        .AddValue(var_type.getAsString(policy))
+        .AddValue(element_type.getAsString(policy))
+        .AddFixItHint(clang::FixItHint::CreateReplacement(clang::CharSourceRange::getCharRange(loop_var->getBeginLoc(), type_end), "const auto &"));
+}
+
 void ForRangeConstVisitor::addMutRefProducer(const clang::Expr * expr, const clang::Expr * prnt, const clang::ValueDecl * inited)
 {
     expr = nullIfNotConsidered(expr);
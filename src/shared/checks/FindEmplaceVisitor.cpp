@@ -7,18 +7,25 @@
 #include "clang/AST/Decl.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
+#include "clang/AST/Stmt.h"
+#include "clang/AST/StmtCXX.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/SourceLocation.h"
+#include "clang/Lex/Lexer.h"
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringRef.h"
 
 #include <algorithm>
 #include <cassert>
 #include <optional>
 #include <string_view>
+#include <string>
 #include <unordered_set>
+#include <vector>
 #include <iterator>
 
 namespace ica {
@@ -38,6 +45,12 @@ FindEmplaceVisitor::FindEmplaceVisitor(clang::CompilerInstance & ci, const Confi
     m_note_id = getCustomDiagID(clang::DiagnosticIDs::Note,
             "'find' called here");
 
+    m_double_lookup_warn_id = getCustomDiagID(double_lookup,
+            "'%0' looks up the key again after '%1'. Consider using a single lookup '%2'");
+
+    m_lookup_note_id = getCustomDiagID(clang::DiagnosticIDs::Note,
+            "'%0' called here");
+
     m_parent_of.emplace(nullptr, nullptr);
     m_stmt_iterators.try_emplace(nullptr);
     m_curr_stmt = nullptr;
@@ -62,14 +75,24 @@ const clang::Expr * passBindingExpr(const clang::Expr * expr)
     return expr;
 }
 
+const clang::Expr * normalizeKeyExpr(const clang::Expr * key)
+{
+    return passBindingExpr(key->IgnoreParenCasts());
+}
+
+const clang::Expr * normalizeContExpr(const clang::Expr * cont)
+{
+    return cont->IgnoreParenImpCasts();
+}
+
 bool isSameKeyExpr(
         clang::ASTContext & context,
         const clang::Expr * key1,
         const clang::Expr * key2,
         const bool ignore_side_effects)
 {
-    const auto * k1 = passBindingExpr(key1->IgnoreParenCasts());
-    const auto * k2 = passBindingExpr(key2->IgnoreParenCasts());
+    const auto * k1 = normalizeKeyExpr(key1);
+    const auto * k2 = normalizeKeyExpr(key2);
 
     return isIdenticalStmt(context,
             k1,
@@ -83,8 +106,8 @@ bool isSameContExpr(
         const clang::Expr * cont2,
         const bool ignore_side_effects)
 {
-    const auto * c1 = cont1->IgnoreParenImpCasts();
-    const auto * c2 = cont2->IgnoreParenImpCasts();
+    const auto * c1 = normalizeContExpr(cont1);
+    const auto * c2 = normalizeContExpr(cont2);
 
     return isIdenticalStmt(context,
             c1,
@@ -229,10 +252,14 @@ const clang::VarDecl * FindEmplaceVisitor::getSameAsFindVar(const clang::CallExp
                                                                const clang::Expr * key)
 {
     const bool ignore_side_effects = true;
+    const auto hash = hashContainerAndKey(cont, key);
 
     for (auto compound_stmt = m_curr_stmt;; compound_stmt = m_parent_of[compound_stmt]) {
-        for (const auto & [var, cont_key_find] : m_stmt_iterators[compound_stmt]) {
-            const auto [it_cont, it_key, _] = cont_key_find;
+        auto & iterators = m_stmt_iterators[compound_stmt];
+        const auto [begin, end] = iterators.by_hash.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            const auto * var = it->second;
+            const auto [it_cont, it_key, _] = iterators.by_var[var];
 
             const bool same_key  = isSameKeyExpr (getContext(), key , it_key , ignore_side_effects);
             const bool same_cont = isSameContExpr(getContext(), cont, it_cont, ignore_side_effects);
@@ -250,6 +277,11 @@ const clang::VarDecl * FindEmplaceVisitor::getSameAsFindVar(const clang::CallExp
     return nullptr;
 }
 
+std::size_t FindEmplaceVisitor::hashContainerAndKey(const clang::Expr * cont, const clang::Expr * key)
+{
+    return llvm::hash_combine(m_hasher(normalizeContExpr(cont)), m_hasher(normalizeKeyExpr(key)));
+}
+
 /// Defines behaviour of function to be memorized
 std::optional<clang::QualType> FindEmplaceVisitor::GetKeyTypeFunctor::operator()(const clang::CXXRecordDecl * decl) const
 {
@@ -306,11 +338,13 @@ bool FindEmplaceVisitor::VisitCXXOperatorCallExpr(clang::CXXOperatorCallExpr * e
 
 namespace {
 
-bool isBadContainer(const clang::QualType & type)
+/// std::map or std::unordered_map, std::set and std::unordered_set as well if 'with_sets'
+bool isBadContainer(const clang::QualType & type, const bool with_sets = false)
 {
     const auto raw_name = getUnqualifiedClassName(type);
     auto cut_template_name = llvm::StringRef(raw_name);
-    return cut_template_name.startswith("std::unordered_map") || cut_template_name.startswith("std::map");
+    return cut_template_name.startswith("std::unordered_map") || cut_template_name.startswith("std::map")
+        || (with_sets && (cut_template_name.startswith("std::unordered_set") || cut_template_name.startswith("std::set")));
 }
 
 bool isNotPiecewiseConstructVariable(const clang::Expr * arg)
@@ -385,12 +419,304 @@ bool FindEmplaceVisitor::VisitCXXMemberCallExpr(clang::CXXMemberCallExpr * expr)
     return true;
 }
 
+namespace {
+
+/// 'count' or 'contains' call, whose result is checked by a condition
+struct CheckedLookup
+{
+    const clang::CXXMemberCallExpr * call = nullptr;
+    /// the key is in the container, when the condition is true
+    bool found_if_true = true;
+};
+
+/// Matches 'cont.count(key)', 'cont.contains(key)', possibly negated or compared with 0
+CheckedLookup getCheckedLookup(const clang::Expr * cond)
+{
+    if (!cond) {
+        return {};
+    }
+
+    bool found_if_true = true;
+    cond = cond->IgnoreParenImpCasts();
+    while (const auto * unary = clang::dyn_cast<clang::UnaryOperator>(cond)) {
+        if (unary->getOpcode() != clang::UO_LNot) {
+            return {};
+        }
+        found_if_true = !found_if_true;
+        cond = unary->getSubExpr()->IgnoreParenImpCasts();
+    }
+
+    if (const auto * binary = clang::dyn_cast<clang::BinaryOperator>(cond)) {
+        const auto * literal = clang::dyn_cast<clang::IntegerLiteral>(binary->getRHS()->IgnoreParenImpCasts());
+        if (!literal || literal->getValue() != 0) {
+            return {};
+        }
+        switch (binary->getOpcode()) {
+            case clang::BO_NE:
+            case clang::BO_GT:
+                break;
+            case clang::BO_EQ:
+                found_if_true = !found_if_true;
+                break;
+            default:
+                return {};
+        }
+        cond = binary->getLHS()->IgnoreParenImpCasts();
+    }
+
+    const bool with_sets = true;
+    const auto * call = clang::dyn_cast<clang::CXXMemberCallExpr>(cond);
+    if (!call || call->getNumArgs() != 1 || !call->getMethodDecl() || !isBadContainer(call->getObjectType(), with_sets)) {
+        return {};
+    }
+
+    const auto method_name = call->getMethodDecl()->getNameInfo().getAsString();
+    if (method_name != "count" && method_name != "contains") {
+        return {};
+    }
+    return {call, found_if_true};
+}
+
+/// Second lookup of a key in a container: 'cont[key]', 'cont.at(key)', 'cont.insert(key)', 'cont.emplace(key, ...)' etc.
+struct Lookup
+{
+    const clang::Expr * call = nullptr;
+    const clang::Expr * cont = nullptr;
+    const clang::Expr * key = nullptr;
+    clang::SourceLocation loc;
+    std::string callee;
+};
+
+Lookup getLookup(const clang::Stmt * stmt, const bool is_map)
+{
+    if (const auto * oper_call = clang::dyn_cast<clang::CXXOperatorCallExpr>(stmt)) {
+        if (oper_call->getOperator() == clang::OO_Subscript && oper_call->getNumArgs() == 2) {
+            return {oper_call, oper_call->getArg(0), oper_call->getArg(1), oper_call->getOperatorLoc(), "operator[]"};
+        }
+        return {};
+    }
+
+    const auto * member_call = clang::dyn_cast<clang::CXXMemberCallExpr>(stmt);
+    if (!member_call || !member_call->getMethodDecl() || member_call->getNumArgs() == 0) {
+        return {};
+    }
+
+    auto method_name = member_call->getMethodDecl()->getNameInfo().getAsString();
+    const auto * key = member_call->getArg(0);
+    if (method_name == "insert") {
+        if (member_call->getNumArgs() != 1) {
+            return {};
+        }
+        if (is_map) {
+            key = getFirstArgOfPair(key);
+        }
+    } else if (method_name == "emplace") {
+        if (is_map && member_call->getNumArgs() < 2) {
+            return {};
+        }
+    } else if (method_name != "at" && method_name != "try_emplace") {
+        return {};
+    }
+
+    if (!key) {
+        return {};
+    }
+    return {member_call, member_call->getImplicitObjectArgument(), key, member_call->getExprLoc(), std::move(method_name)};
+}
+
+/// Whether the method leaves the object unchanged: it's 'const' or has a 'const' overload, e.g. 'find'
+bool isReadOnly(const clang::CXXMethodDecl * method)
+{
+    if (method->isConst()) {
+        return true;
+    }
+    const auto overloads = method->getParent()->lookup(method->getDeclName());
+    return std::any_of(overloads.begin(), overloads.end(), [method](const clang::NamedDecl * decl) {
+        const auto * overload = clang::dyn_cast_or_null<clang::CXXMethodDecl>(decl->getAsFunction());
+        return overload && overload->isConst() && overload->getNumParams() == method->getNumParams();
+    });
+}
+
+/// Whether 'stmt' itself (its children aren't checked) may modify the value of 'expr':
+/// assigns or increments it, takes its address, calls its non-'const' method or binds a non-'const' reference to it
+bool modifies(clang::ASTContext & context, const clang::Stmt * stmt, const clang::Expr * expr)
+{
+    const auto is_expr = [&context, expr](const clang::Expr * other) {
+        const bool ignore_side_effects = false;
+        return isIdenticalStmt(context, expr->IgnoreParenCasts(), other->IgnoreParenCasts(), ignore_side_effects);
+    };
+    const auto binds_mut_ref = [&is_expr](const clang::FunctionDecl * callee, const auto args) {
+        if (!callee) {
+            return false;
+        }
+        const auto num_args = std::min<std::size_t>(callee->getNumParams(), args.size());
+        for (std::size_t i = 0; i < num_args; ++i) {
+            const auto type = callee->getParamDecl(i)->getType();
+            if (type->isReferenceType() && !type.getNonReferenceType().isConstQualified() && is_expr(args[i])) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (const auto * binary = clang::dyn_cast<clang::BinaryOperator>(stmt)) {
+        return binary->isAssignmentOp() && is_expr(binary->getLHS());
+    }
+    if (const auto * unary = clang::dyn_cast<clang::UnaryOperator>(stmt)) {
+        return (unary->isIncrementDecrementOp() || unary->getOpcode() == clang::UO_AddrOf) && is_expr(unary->getSubExpr());
+    }
+    if (const auto * construct = clang::dyn_cast<clang::CXXConstructExpr>(stmt)) {
+        return binds_mut_ref(construct->getConstructor(), llvm::makeArrayRef(construct->getArgs(), construct->getNumArgs()));
+    }
+    if (const auto * member_call = clang::dyn_cast<clang::CXXMemberCallExpr>(stmt)) {
+        const auto * method = member_call->getMethodDecl();
+        if (method && !isReadOnly(method) && is_expr(member_call->getImplicitObjectArgument())) {
+            return true;
+        }
+    }
+    if (const auto * call = clang::dyn_cast<clang::CallExpr>(stmt)) {
+        auto args = llvm::makeArrayRef(call->getArgs(), call->getNumArgs());
+        // the object of a member operator is the first argument
+        if (const auto * method = clang::dyn_cast_or_null<clang::CXXMethodDecl>(call->getDirectCallee());
+                method && clang::isa<clang::CXXOperatorCallExpr>(call) && !args.empty()) {
+            if (!isReadOnly(method) && is_expr(args.front())) {
+                return true;
+            }
+            args = args.drop_front();
+        }
+        return binds_mut_ref(call->getDirectCallee(), args);
+    }
+    return false;
+}
+
+/// Finds the first lookup of 'key' in 'cont' within 'stmt' in the order of evaluation.
+/// The search stops at a modification of 'cont' or 'key', then the lookup isn't a repeated one.
+/// Lambda bodies are skipped, a lookup in a loop isn't reported: it may follow a modification
+/// made by the previous iteration. Returns whether the search is over
+bool findFirstLookup(clang::ASTContext & context,
+                     const clang::Stmt * stmt,
+                     const clang::Expr * cont,
+                     const clang::Expr * key,
+                     const bool is_map,
+                     const bool in_loop,
+                     std::optional<Lookup> & result)
+{
+    if (!stmt || clang::isa<clang::LambdaExpr>(stmt)) {
+        return false;
+    }
+
+    const bool ignore_side_effects = false;
+    if (auto lookup = getLookup(stmt, is_map); lookup.call && !in_loop) {
+        if (isSameContExpr(context, cont, lookup.cont, ignore_side_effects)
+                && isSameKeyExpr(context, key, lookup.key, ignore_side_effects)) {
+            result = std::move(lookup);
+            return true;
+        }
+    }
+
+    if (modifies(context, stmt, normalizeContExpr(cont)) || modifies(context, stmt, normalizeKeyExpr(key))) {
+        return true;
+    }
+
+    const bool is_loop = clang::isa<clang::ForStmt>(stmt) || clang::isa<clang::CXXForRangeStmt>(stmt)
+        || clang::isa<clang::WhileStmt>(stmt) || clang::isa<clang::DoStmt>(stmt);
+    for (const auto * child : stmt->children()) {
+        if (findFirstLookup(context, child, cont, key, is_map, in_loop || is_loop, result)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Source text of 'range' as written, empty if it's (partially) from a macro
+std::string getSourceText(const clang::CharSourceRange & range, clang::ASTContext & context)
+{
+    if (range.getBegin().isMacroID() || range.getEnd().isMacroID()) {
+        return {};
+    }
+    return clang::Lexer::getSourceText(range, context.getSourceManager(), context.getLangOpts()).str();
+}
+
+} // namespace anonymous
+
+bool FindEmplaceVisitor::VisitIfStmt(clang::IfStmt * stmt)
+{
+    if (shouldProcessStmt(stmt, getSM())) {
+        checkDoubleLookup(stmt->getCond(), stmt->getThen(), stmt->getElse());
+    }
+    return true;
+}
+
+bool FindEmplaceVisitor::VisitConditionalOperator(clang::ConditionalOperator * expr)
+{
+    if (shouldProcessExpr(expr, getSM())) {
+        checkDoubleLookup(expr->getCond(), expr->getTrueExpr(), expr->getFalseExpr());
+    }
+    return true;
+}
+
+void FindEmplaceVisitor::checkDoubleLookup(const clang::Expr * cond, const clang::Stmt * then_stmt, const clang::Stmt * else_stmt)
+{
+    if (!getCheck(double_lookup)) {
+        return;
+    }
+
+    const auto checked_lookup = getCheckedLookup(cond);
+    const auto * lookup_call = checked_lookup.call;
+    if (!lookup_call) {
+        return;
+    }
+
+    const auto * cont = lookup_call->getImplicitObjectArgument();
+    const auto * key = lookup_call->getArg(0);
+    // 'cont.' or 'cont->'
+    const auto cont_access = getSourceText(clang::CharSourceRange::getCharRange(lookup_call->getBeginLoc(), lookup_call->getExprLoc()), getContext());
+    const auto key_text = getSourceText(clang::CharSourceRange::getTokenRange(key->getSourceRange()), getContext());
+    if (cont_access.empty() || key_text.empty()) {
+        return;
+    }
+
+    const bool is_map = isBadContainer(lookup_call->getObjectType());
+    const auto method_name = lookup_call->getMethodDecl()->getNameInfo().getAsString();
+    const auto find_rewrite = "auto it = " + cont_access + "find(" + key_text + ")";
+    const auto insert_rewrite = is_map
+        ? cont_access + "try_emplace(" + key_text + ", ...)"
+        : cont_access + "insert(" + key_text + ").second";
+
+    const auto report_lookup = [&](const clang::Stmt * branch, const bool found) {
+        const bool in_loop = false;
+        std::optional<Lookup> lookup;
+        findFirstLookup(getContext(), branch, cont, key, is_map, in_loop, lookup);
+        if (!lookup) {
+            return false;
+        }
+        // 'operator[]' reads the found element or inserts the missing one
+        const bool is_read = lookup->callee == "at" || (lookup->callee == "operator[]" && found);
+        report(lookup->loc, m_double_lookup_warn_id)
+            .AddValue(lookup->callee)
+            .AddValue(method_name)
+            .AddValue(is_read ? find_rewrite : insert_rewrite);
+        return true;
+    };
+
+    // both branches are checked, the note is emitted once per condition
+    const bool then_reported = report_lookup(then_stmt, checked_lookup.found_if_true);
+    const bool else_reported = report_lookup(else_stmt, !checked_lookup.found_if_true);
+    if (then_reported || else_reported) {
+        report(lookup_call->getExprLoc(), m_lookup_note_id)
+            .AddValue(method_name);
+    }
+}
+
 /// finds all local stringstream decls
 bool FindEmplaceVisitor::VisitVarDecl(clang::VarDecl * var_decl)
 {
     if (shouldProcessDecl(var_decl, getSM()) && var_decl->isLocalVarDecl()) {
         if (const auto [cont, key, find] = getContainerAndKey(var_decl->getInit()); cont && key && find) {
-            m_stmt_iterators[m_curr_stmt].try_emplace(var_decl, cont, key, find);
+            auto & iterators = m_stmt_iterators[m_curr_stmt];
+            if (iterators.by_var.try_emplace(var_decl, cont, key, find).second) {
+                iterators.by_hash.emplace(hashContainerAndKey(cont, key), var_decl);
+            }
         }
     }
 
@@ -402,6 +728,7 @@ void FindEmplaceVisitor::clear()
     resetContext();
     m_calls.clear();
     m_stmt_iterators.clear();
+    m_hasher.clear();
     m_curr_stmt = nullptr;
 }
 
@@ -487,8 +814,8 @@ void FindEmplaceVisitor::reportCompoundStmt()
         for (auto comp_stmt = m_curr_stmt;; comp_stmt = m_parent_of[comp_stmt]) {
             auto iterators_it = m_stmt_iterators.find(comp_stmt);
             if (iterators_it != m_stmt_iterators.end()) {
-                auto container_key_find_it = iterators_it->second.find(decl);
-                if (container_key_find_it != iterators_it->second.end()) {
+                auto container_key_find_it = iterators_it->second.by_var.find(decl);
+                if (container_key_find_it != iterators_it->second.by_var.end()) {
                     return container_key_find_it->second;
                 }
             }
@@ -0,0 +1,153 @@
+#include "shared/checks/HotPathVisitor.h"
+#include "shared/common/Common.h"
+
+#include "clang/AST/Attr.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <deque>
+
+namespace ica {
+
+HotPathVisitor::HotPathVisitor(clang::CompilerInstance & ci, const Config & config)
+    : Visitor(ci, config)
+{
+    if (!isEnabled()) return;
+
+    m_allocation_id = getCustomDiagID(hot_path_allocation, "'%0' may allocate memory on the hot path of %q1");
+    m_blocking_id = getCustomDiagID(hot_path_blocking, "'%0' may block on the hot path of %q1");
+    m_throw_id = getCustomDiagID(hot_path_throw, "'%0' may throw on the hot path of %q1");
+    m_call_note_id = getCustomDiagID(clang::DiagnosticIDs::Note, "%q0 is called here");
+}
+
+namespace {
+
+constexpr llvm::StringLiteral hot_annotation = "ica::hot";
+constexpr llvm::StringLiteral hot_comment = "ICA-HOT";
+
+bool hasHotAnnotation(const clang::FunctionDecl * decl)
+{
+    for (const auto * redecl : decl->redecls()) {
+        for (const auto * attr : redecl->specific_attrs<clang::AnnotateAttr>()) {
+            if (attr->getAnnotation() == hot_annotation) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool hasHotComment(const llvm::StringRef line)
+{
+    const auto comment = line.find("//");
+    return comment != llvm::StringRef::npos && line.find(hot_comment, comment) != llvm::StringRef::npos;
+}
+
+/// '// ICA-HOT' on the line where a declaration starts or on the line above
+bool hasHotComment(const clang::FunctionDecl * decl, const clang::SourceManager & source_manager)
+{
+    for (const auto * redecl : decl->redecls()) {
+        const auto * templ = redecl->getDescribedFunctionTemplate();
+        const auto loc = source_manager.getExpansionLoc(templ ? templ->getBeginLoc() : redecl->getBeginLoc());
+        if (loc.isInvalid()) {
+            continue;
+        }
+
+        const auto [file_id, offset] = source_manager.getDecomposedLoc(loc);
+        bool invalid = false;
+        const auto buffer = source_manager.getBufferData(file_id, &invalid);
+        if (invalid) {
+            continue;
+        }
+
+        const auto line_begin = buffer.rfind('\n', offset) + 1; // npos + 1 == 0
+        const auto line = buffer.slice(line_begin, buffer.find('\n', offset));
+        const auto prev_line = line_begin > 0
+            ? buffer.slice(buffer.rfind('\n', line_begin - 1) + 1, line_begin - 1)
+            : llvm::StringRef();
+
+        if (hasHotComment(line) || hasHotComment(prev_line)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isHotFunction(const clang::FunctionDecl * decl, const clang::SourceManager & source_manager)
+{
+    if (const auto * pattern = decl->getTemplateInstantiationPattern()) {
+        decl = pattern;
+    }
+    return hasHotAnnotation(decl) || hasHotComment(decl, source_manager);
+}
+
+} // namespace anonymous
+
+bool HotPathVisitor::VisitFunctionDecl(clang::FunctionDecl * decl)
+{
+    if (!shouldProcessDecl(decl, getSM()) || !decl->doesThisDeclarationHaveABody() || decl->isDependentContext()) {
+        return true;
+    }
+
+    if (isHotFunction(decl, getSM())) {
+        m_hot_functions.push_back(decl);
+    }
+    return true;
+}
+
+void HotPathVisitor::reportEffect(const clang::FunctionDecl * hot_function, const Effect effect, const DiagnosticID warn_id)
+{
+    // breadth-first, so every reached function keeps its shortest chain: the caller and the call site
+    llvm::DenseMap<const clang::FunctionDecl *, std::pair<const clang::FunctionDecl *, const clang::Expr *>> callers;
+    callers.try_emplace(hot_function, nullptr, nullptr);
+    std::deque<const clang::FunctionDecl *> queue{hot_function};
+    auto & summaries = getEffectSummaries();
+
+    while (!queue.empty()) {
+        const auto * function = queue.front();
+        queue.pop_front();
+
+        for (const auto & site : summaries.getCallGraph().getCallSites(function)) {
+            if (!reachesCaller(site, effect)) {
+                continue;
+            }
+            if (const auto effect_name = getDirectEffect(site, effect); effect_name) {
+                if (shouldProcessStmt(site.expr, getSM()) && m_reported.emplace(hot_function, site.expr, effect).second) {
+                    report(site.expr->getExprLoc(), warn_id)
+                        .AddValue(*effect_name)
+                        .AddValue(hot_function);
+
+                    for (const auto * callee = function; callee != hot_function;) {
+                        const auto [caller, call] = callers.lookup(callee);
+                        report(call->getExprLoc(), m_call_note_id)
+                            .AddValue(callee);
+                        callee = caller;
+                    }
+                }
+                continue;
+            }
+
+            if (const auto * callee = CallGraph::getFollowedDefinition(site.callee, getSM());
+                    callee && summaries.mayHave(callee, effect) && callers.try_emplace(callee, function, site.expr).second) {
+                queue.push_back(callee);
+            }
+        }
+    }
+}
+
+void HotPathVisitor::printDiagnostic(clang::ASTContext &)
+{
+    for (const auto * hot_function : m_hot_functions) {
+        if (getCheck(hot_path_allocation)) {
+            reportEffect(hot_function, Effect::Allocation, m_allocation_id);
+        }
+        if (getCheck(hot_path_blocking)) {
+            reportEffect(hot_function, Effect::Blocking, m_blocking_id);
+        }
+        if (getCheck(hot_path_throw)) {
+            reportEffect(hot_function, Effect::Throw, m_throw_id);
+        }
+    }
+}
+
+} // namespace ica
@@ -43,12 +43,10 @@ bool LockGuardReleaseVisitor::VisitCXXMemberCallExpr(clang::CXXMemberCallExpr *
     }
 
     auto record_decl = ce->getRecordDecl();
-    if (!record_decl ||
-            !(record_decl = record_decl->getCanonicalDecl()) ||
-            (record_decl->getQualifiedNameAsString() != "std::unique_lock" &&
-            record_decl->getQualifiedNameAsString() != "std::shared_lock")) {
+    if (!isStdReleasableLock(record_decl)) {
         return true;
     }
+    record_decl = record_decl->getCanonicalDecl();
 
     const auto parents = getContext().getParents(*ce);
     bool should_warn = true;
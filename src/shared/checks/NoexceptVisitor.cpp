@@ -1,6 +1,7 @@
 #include "shared/checks/NoexceptVisitor.h"
 #include "shared/common/Common.h"
 #include "shared/common/DiagnosticsBuilder.h"
+#include "shared/common/EffectSummaries.h"
 
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
@@ -10,13 +11,16 @@
 #include "clang/Basic/ExceptionSpecificationType.h"
 #include "clang/Basic/LLVM.h"
 #include "clang/Basic/OperatorKinds.h"
+#include "clang/Sema/Sema.h"
 
+#include <algorithm>
 #include <functional>
 
 namespace ica {
 
 NoexceptVisitor::NoexceptVisitor(clang::CompilerInstance & ci, const Config & config)
     : Visitor(ci, config)
+    , m_ci(ci)
 {
     if (!isEnabled()) {
         return;
@@ -24,115 +28,265 @@ NoexceptVisitor::NoexceptVisitor(clang::CompilerInstance & ci, const Config & co
 
     m_warn_id = getCustomDiagID(noexcept_check, "there is call of non-noexcept function within noexcept-specified");
     m_note_id = getCustomDiagID(clang::DiagnosticIDs::Note, "non-noexcept function call is here");
+    m_missing_id = getCustomDiagID(missing_noexcept, "%q0 can't throw, but it isn't declared as 'noexcept'");
+    m_element_id = getCustomDiagID(throwing_move_element, "move constructor of %0 isn't 'noexcept', "
+                                                          "%1 copies the elements instead of moving them");
+    m_element_note_id = getCustomDiagID(clang::DiagnosticIDs::Note, "%0 of %1 is instantiated here");
 }
 
 namespace {
 
-bool isNoexcept(const clang::FunctionDecl * func_decl)
+bool shouldReport(const clang::Expr * call, const clang::FunctionDecl * func_decl, EffectSummaries & summaries)
 {
-    auto ex_spec = func_decl->getExceptionSpecType();
-    return  ex_spec == clang::EST_DynamicNone ||
-            ex_spec == clang::EST_NoThrow ||
-            ex_spec == clang::EST_BasicNoexcept ||
-            ex_spec == clang::EST_DependentNoexcept ||
-            ex_spec >= clang::EST_NoexceptTrue; // NoexceptTrue < Unevaluated < Uninstantiated < Unparsed. We assume that all those will be evaluated to noexcept(true)
-}
-
-bool isAssert(const clang::FunctionDecl * func_decl)
-{
-    if (const auto * id = func_decl->getIdentifier()) {
-        return id->isStr("__assert_fail");
-    }
-    return false;
-}
-
-bool shouldReport(const clang::FunctionDecl * func_decl)
-{
-    if (!func_decl) {
+    if (!func_decl || isAssert(func_decl) || isNoexcept(func_decl)) {
         return false;
     }
 
-    return !func_decl->hasBody() && !(isAssert(func_decl) || isNoexcept(func_decl));
+    // classified as the call sites of the summarized functions: by the call itself (a function without a body,
+    // a std function known to throw) or by everything the callee calls
+    return summaries.mayThrow(CallSite{call, func_decl});
 }
 
-bool shouldReport(const clang::CXXMethodDecl * method_decl)
+bool shouldReport(const clang::Expr * call, const clang::CXXMethodDecl * method_decl, EffectSummaries & summaries)
 {
     if (!method_decl) {
         return false;
     }
-    return shouldReport(clang::dyn_cast<clang::FunctionDecl>(method_decl)) &&
-        !(method_decl->getExceptionSpecType() == clang::EST_None &&
-        method_decl->isDefaulted());
+    return !(method_decl->getExceptionSpecType() == clang::EST_None &&
+        method_decl->isDefaulted()) &&
+        shouldReport(call, clang::dyn_cast<clang::FunctionDecl>(method_decl), summaries);
 }
 
-bool shouldReport(const clang::CXXConstructExpr * ctor_expr)
+bool shouldReport(const clang::CXXConstructExpr * ctor_expr, EffectSummaries & summaries)
 {
     if (!ctor_expr) {
         return false;
     }
     auto ctor_decl = ctor_expr->getConstructor();
 
-    return shouldReport(ctor_decl) &&
-        !(ctor_decl->getExceptionSpecType() == clang::EST_None && ctor_decl->isDefaulted());
+    return !(ctor_decl->getExceptionSpecType() == clang::EST_None && ctor_decl->isDefaulted()) &&
+        shouldReport(ctor_expr, ctor_decl, summaries);
 }
 
-bool shouldReport(const clang::CXXMemberCallExpr * member_call)
+bool shouldReport(const clang::CXXMemberCallExpr * member_call, EffectSummaries & summaries)
 {
     if (!member_call) {
         return false;
     }
-    return shouldReport(member_call->getMethodDecl());
+    return shouldReport(member_call, member_call->getMethodDecl(), summaries);
 }
 
-bool shouldReport(const clang::CXXOperatorCallExpr * op_call)
+bool shouldReport(const clang::CXXOperatorCallExpr * op_call, EffectSummaries & summaries)
 {
     if (!op_call) {
         return false;
     }
 
     if (op_call->getOperator() == clang::OO_Call) {
-        return shouldReport(op_call->getDirectCallee());
+        return shouldReport(op_call, op_call->getDirectCallee(), summaries);
     } else if (op_call->isAssignmentOp()) {
-        return shouldReport(clang::dyn_cast<clang::CXXMethodDecl>(op_call->getDirectCallee()));
+        return shouldReport(op_call, clang::dyn_cast<clang::CXXMethodDecl>(op_call->getDirectCallee()), summaries);
     }
     return false;
 }
 
-bool shouldReport(const clang::CallExpr * call_expr)
+bool shouldReport(const clang::CallExpr * call_expr, EffectSummaries & summaries)
 {
     if (!call_expr) {
         return false;
     }
 
     if (auto member_call = clang::dyn_cast<clang::CXXMemberCallExpr>(call_expr)) {
-        return shouldReport(member_call);
+        return shouldReport(member_call, summaries);
     } else if (auto op_call = clang::dyn_cast<clang::CXXOperatorCallExpr>(call_expr)) {
-        return shouldReport(op_call);
+        return shouldReport(op_call, summaries);
     } else {
-        return shouldReport(call_expr->getDirectCallee());
+        return shouldReport(call_expr, call_expr->getDirectCallee(), summaries);
     }
 }
 
-bool shouldReport(const clang::Expr * expr)
+bool shouldReport(const clang::Expr * expr, EffectSummaries & summaries)
 {
     if (!expr) {
         return false;
     }
 
-    return shouldReport(clang::dyn_cast<clang::CallExpr>(expr)) ||
-        shouldReport(clang::dyn_cast<clang::CXXConstructExpr>(expr)) ||
+    return shouldReport(clang::dyn_cast<clang::CallExpr>(expr), summaries) ||
+        shouldReport(clang::dyn_cast<clang::CXXConstructExpr>(expr), summaries) ||
         clang::dyn_cast<clang::CXXNewExpr>(expr) ||
         clang::dyn_cast<clang::CXXThrowExpr>(expr);
 }
+
+/// Functions which are worth being 'noexcept': containers and algorithms use move operations and 'swap'
+/// only if they don't throw, otherwise they copy
+bool isNoexceptCandidate(const clang::FunctionDecl * decl)
+{
+    if (const auto * ctor = clang::dyn_cast<clang::CXXConstructorDecl>(decl); ctor && ctor->isMoveConstructor()) {
+        return true;
+    }
+    if (const auto * method = clang::dyn_cast<clang::CXXMethodDecl>(decl); method && method->isMoveAssignmentOperator()) {
+        return true;
+    }
+    return decl->getIdentifier() && decl->getName() == "swap";
+}
+
+/// The call can't throw for sure: it's a call of a 'noexcept' function
+bool isProvenNotThrowing(const CallSite & site)
+{
+    if (!site.callee) { // 'throw' or indirect call
+        return false;
+    }
+    return isNoexcept(site.callee) || isAssert(site.callee) || site.callee->isExternC();
+}
+
+/// Location to insert 'noexcept' at: after the parameters list, if there are no qualifiers to insert it after
+clang::SourceLocation getNoexceptLocation(const clang::FunctionDecl * decl)
+{
+    if (const auto * method = clang::dyn_cast<clang::CXXMethodDecl>(decl);
+            method && (method->getMethodQualifiers().hasQualifiers() || method->getRefQualifier() != clang::RQ_None)) {
+        return {};
+    }
+
+    const auto type_loc = decl->getFunctionTypeLoc();
+    if (!type_loc || type_loc.getRParenLoc().isMacroID()) {
+        return {};
+    }
+    return type_loc.getRParenLoc().getLocWithOffset(1);
+}
+
+/// Whether the constructor may throw. The exception specification of a defaulted or an implicit one
+/// follows from the bases and the members, Sema computes it on demand
+bool mayThrow(clang::Sema & sema, const clang::CXXConstructorDecl * ctor)
+{
+    const auto * proto = ctor->getType()->getAs<clang::FunctionProtoType>();
+    if (proto && clang::isUnresolvedExceptionSpec(proto->getExceptionSpecType())) {
+        proto = sema.ResolveExceptionSpec(ctor->getLocation(), proto);
+    }
+    return proto && !proto->isNothrow();
+}
+
+/// Move constructor, which makes the containers copy the elements: it may throw, while there is a copy constructor
+const clang::CXXConstructorDecl * getThrowingMoveConstructor(clang::Sema & sema, const clang::CXXRecordDecl * record)
+{
+    const clang::CXXConstructorDecl * move_ctor = nullptr;
+    bool has_copy_ctor = false;
+    for (const auto * ctor : record->ctors()) {
+        if (ctor->isDeleted()) {
+            continue;
+        }
+        if (ctor->isMoveConstructor()) {
+            move_ctor = ctor;
+        } else if (ctor->isCopyConstructor()) {
+            has_copy_ctor = true;
+        }
+    }
+
+    if (!move_ctor || !has_copy_ctor || !mayThrow(sema, move_ctor)) {
+        return nullptr;
+    }
+    return move_ctor;
+}
+
+/// Class template of namespace std (or of its inline namespace) by name
+const clang::ClassTemplateDecl * findStdClassTemplate(clang::ASTContext & context, const llvm::StringRef name)
+{
+    for (const auto * std_decl : context.getTranslationUnitDecl()->lookup(&context.Idents.get("std"))) {
+        const auto * std_namespace = clang::dyn_cast<clang::NamespaceDecl>(std_decl);
+        if (!std_namespace) {
+            continue;
+        }
+        // declarations of inline namespaces are visible in the enclosing namespace
+        for (const auto * decl : std_namespace->lookup(&context.Idents.get(name))) {
+            if (const auto * class_template = clang::dyn_cast<clang::ClassTemplateDecl>(decl)) {
+                return class_template;
+            }
+        }
+    }
+    return nullptr;
+}
+
 } // namespace anonymous
 
+void NoexceptVisitor::checkContainerElements(clang::ASTContext & context, const llvm::StringRef container_name)
+{
+    const auto * container = findStdClassTemplate(context, container_name);
+    if (!container) {
+        return;
+    }
+
+    const auto display_name = "std::" + container_name.str();
+    for (const auto * specialization : container->specializations()) {
+        const auto & args = specialization->getTemplateArgs();
+        if (args.size() == 0 || args[0].getKind() != clang::TemplateArgument::Type) {
+            continue;
+        }
+
+        const auto * element = args[0].getAsType()->getAsCXXRecordDecl();
+        if (!element || !(element = element->getDefinition()) || element->isDependentContext()) {
+            continue;
+        }
+
+        const auto instantiation_loc = specialization->getPointOfInstantiation();
+        if (instantiation_loc.isInvalid() || getSM().isInSystemHeader(instantiation_loc)
+                || !shouldProcessDecl(element, getSM()) || m_reported_elements.count(element)) {
+            continue;
+        }
+
+        if (getThrowingMoveConstructor(m_ci.getSema(), element)) {
+            m_reported_elements.insert(element);
+            report(element->getLocation(), m_element_id)
+                .AddValue(element)
+                .AddValue(display_name);
+            report(instantiation_loc, m_element_note_id)
+                .AddValue(display_name)
+                .AddValue(element);
+        }
+    }
+}
+
+void NoexceptVisitor::printDiagnostic(clang::ASTContext & context)
+{
+    if (getCheck(throwing_move_element)) {
+        checkContainerElements(context, "vector");
+        checkContainerElements(context, "deque");
+    }
+}
+
+void NoexceptVisitor::checkMissingNoexcept(const clang::FunctionDecl * decl)
+{
+    if (decl->getExceptionSpecType() != clang::EST_None || decl->isDefaulted() || decl->isDeleted() || decl->isImplicit()
+            || decl->isDependentContext() || decl->getTemplateInstantiationPattern() || !isNoexceptCandidate(decl)) {
+        return;
+    }
+
+    const auto & call_sites = getEffectSummaries().getCallGraph().getCallSites(decl);
+    if (!std::all_of(call_sites.begin(), call_sites.end(), isProvenNotThrowing)) {
+        return;
+    }
+
+    // all the declarations need 'noexcept', so only a single declaration is fixed automatically
+    const bool single_decl = decl->isFirstDecl() && decl->getMostRecentDecl() == decl;
+    if (const auto loc = single_decl ? getNoexceptLocation(decl) : clang::SourceLocation(); loc.isValid()) {
+        report(decl->getLocation(), m_missing_id)
+                .AddValue(decl)
+                .AddFixItHint(clang::FixItHint::CreateInsertion(loc, " noexcept"));
+    } else {
+        report(decl->getLocation(), m_missing_id)
+                .AddValue(decl);
+    }
+}
+
 bool NoexceptVisitor::VisitFunctionDecl(clang::FunctionDecl * decl)
 {
     if (!shouldProcessDecl(decl, getSM()) || !decl->doesThisDeclarationHaveABody()) {
         return true;
     }
 
-    if (!isNoexcept(decl) ||
+    if (getCheck(missing_noexcept)) {
+        checkMissingNoexcept(decl);
+    }
+
+    if (!getCheck(noexcept_check) || !isNoexcept(decl) ||
         (decl->isTemplateInstantiation() &&
         (decl->getExceptionSpecType() >= clang::EST_Unevaluated || decl->getExceptionSpecType() == clang::EST_DependentNoexcept))) {
         return true;
@@ -151,7 +305,7 @@ bool NoexceptVisitor::VisitFunctionDecl(clang::FunctionDecl * decl)
                     clang::isa<clang::LambdaExpr>(sub_stmt)) {
                     continue;
                 }
-                if (shouldReport(clang::dyn_cast<clang::Expr>(sub_stmt))) {
+                if (shouldReport(clang::dyn_cast<clang::Expr>(sub_stmt), getEffectSummaries())) {
                     return sub_stmt;
                 }
                 if (auto * result = find_reportable_child(sub_stmt); result) {
@@ -8,24 +8,68 @@
 
 #include "llvm/Support/Path.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace ica {
 
+namespace {
+
+/// The name, which is used in '-add-plugin', '-plugin' and '-plugin-arg-<name>' of the command line
+constexpr const char * plugin_name = "ica-plugin";
+
+/// Whether ICA is the main action ('-plugin ica-plugin')
+bool isMainAction(const clang::CompilerInstance & ci)
+{
+    const auto & opts = ci.getFrontendOpts();
+    return opts.ProgramAction == clang::frontend::PluginAction && opts.ActionName == plugin_name;
+}
+
+/// Whether ICA is added to the main action ('-add-plugin ica-plugin')
+bool isAddedAction(const clang::CompilerInstance & ci)
+{
+    const auto & actions = ci.getFrontendOpts().AddPluginActions;
+    return std::find(actions.begin(), actions.end(), plugin_name) != actions.end();
+}
+
+} // namespace anonymous
+
 class Action : public clang::PluginASTAction
 {
 public:
-    explicit Action() = default;
-
     virtual std::unique_ptr<clang::ASTConsumer>
     CreateASTConsumer(clang::CompilerInstance & ci, llvm::StringRef in_file) override
     {
+        if (!m_config.isSampled(in_file)) {
+            return std::make_unique<clang::ASTConsumer>();
+        }
+
+        auto error = m_config.loadConfigFiles(in_file);
+        if (!error) {
+            error = m_config.resolveOptions(Consumer::getOptionDeclarations());
+        }
+        if (error) {
+            auto & diag = ci.getDiagnostics();
+            diag.Report(diag.getCustomDiagID(clang::DiagnosticsEngine::Error, "error while parsing ICA config file %0"))
+                << *error;
+            return std::make_unique<clang::ASTConsumer>();
+        }
+
         return std::make_unique<Consumer>(ci, std::move(m_config));
     }
 
-    virtual bool ParseArgs(const clang::CompilerInstance & ci, const std::vector<std::string> & args) override
+protected:
+    /// Parses the arguments of '-plugin-arg-ica-plugin', prints an error if they are malformed
+    bool parseArgs(const clang::CompilerInstance & ci)
     {
-        if (auto error = m_config.parse(args); error) {
+        const auto & plugin_args = ci.getFrontendOpts().PluginArgs;
+        const auto it = plugin_args.find(plugin_name);
+
+        auto error = m_config.parse(it != plugin_args.end() ? it->second : std::vector<std::string>{});
+        if (!error) {
+            error = m_config.resolveOptions(Consumer::getOptionDeclarations());
+        }
+        if (error) {
             llvm::outs() << "Error while parsing ICA args: " << *error << '\n';
             return false;
         }
@@ -33,15 +77,78 @@ public:
         return true;
     }
 
+protected:
+    Config m_config;
+};
+
+/// '-add-plugin ica-plugin': checks run before the main action, so their errors stop the code generation.
+/// Clang adds 'AddBeforeMainAction' plugins on its own, so the action declines if it isn't requested
+class AddedAction : public Action
+{
+public:
+    virtual bool ParseArgs(const clang::CompilerInstance & ci, const std::vector<std::string> &) override
+    {
+        if (isMainAction(ci) || !isAddedAction(ci) || !parseArgs(ci)) {
+            return false;
+        }
+
+        if (m_config.get_mode() == Config::Mode::Replace) {
+            llvm::outs() << "Error while parsing ICA args: 'mode=replace' requires running ICA with '-plugin ica-plugin'\n";
+            return false;
+        }
+
+        return true;
+    }
+
     virtual clang::PluginASTAction::ActionType getActionType() override
     {
         return AddBeforeMainAction;
     }
+};
 
-private:
-    Config m_config;
+/// '-plugin ica-plugin' with 'mode=replace': ICA is the main action, no code is generated.
+/// The output file is an empty stamp, so build systems don't rerun the analysis of an unchanged file
+class MainAction : public Action
+{
+public:
+    virtual std::unique_ptr<clang::ASTConsumer>
+    CreateASTConsumer(clang::CompilerInstance & ci, llvm::StringRef in_file) override
+    {
+        // the stamp is removed by clang if an error is reported
+        if (!ci.createDefaultOutputFile(/*Binary=*/true, in_file, "o")) {
+            return nullptr;
+        }
+
+        return Action::CreateASTConsumer(ci, in_file);
+    }
+
+    virtual bool ParseArgs(const clang::CompilerInstance & ci, const std::vector<std::string> &) override
+    {
+        // '-add-plugin ica-plugin' is served by 'AddedAction'
+        if (!isMainAction(ci)) {
+            return false;
+        }
+
+        if (!parseArgs(ci)) {
+            return false;
+        }
+
+        if (m_config.get_mode() != Config::Mode::Replace) {
+            llvm::outs() << "Error while parsing ICA args: '-plugin ica-plugin' requires 'mode=replace'\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    // 'Cmdline' is accepted by '-plugin', and with '-add-plugin' it would run after the main action
+    virtual clang::PluginASTAction::ActionType getActionType() override
+    {
+        return Cmdline;
+    }
 };
 
-static clang::FrontendPluginRegistry::Add<Action> X("ica-plugin", "ITIVITI cpp analyzer");
+static clang::FrontendPluginRegistry::Add<MainAction> X(plugin_name, "ITIVITI cpp analyzer");
+static clang::FrontendPluginRegistry::Add<AddedAction> Y("ica-plugin-added", "ITIVITI cpp analyzer, before the main action");
 
 } // namespace ica
@@ -0,0 +1,195 @@
+#include "shared/common/CallGraph.h"
+#include "shared/common/Common.h"
+
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+
+namespace ica {
+
+namespace {
+
+bool isInStd(const clang::Decl * decl)
+{
+    for (const auto * context = decl->getDeclContext(); context; context = context->getParent()) {
+        if (context->isStdNamespace()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Functions of namespace std aren't followed, but the free ones (e.g. 'std::for_each', 'std::sort', 'std::invoke')
+/// call their callable arguments right away, unlike constructors and methods, which rather store them
+bool callsArguments(const clang::FunctionDecl * callee)
+{
+    if (!callee || clang::isa<clang::CXXMethodDecl>(callee) || !isInStd(callee)) {
+        return false;
+    }
+    // the callable runs on another thread or later
+    return !callee->getIdentifier() || callee->getName() != "async";
+}
+
+class CallSiteCollector : public clang::RecursiveASTVisitor<CallSiteCollector>
+{
+public:
+    explicit CallSiteCollector(std::vector<CallSite> & call_sites)
+        : m_call_sites(call_sites)
+    { }
+
+    bool TraverseCXXTryStmt(clang::CXXTryStmt * stmt)
+    {
+        ++m_try_depth;
+        const bool result = TraverseStmt(stmt->getTryBlock());
+        --m_try_depth;
+        if (!result) {
+            return false;
+        }
+
+        for (unsigned i = 0; i < stmt->getNumHandlers(); ++i) {
+            if (!TraverseStmt(stmt->getHandler(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Captures are initialized where the lambda is created, only the body is executed when it's called
+    bool TraverseLambdaExpr(clang::LambdaExpr * expr)
+    {
+        for (auto * init : expr->capture_inits()) {
+            if (!TraverseStmt(init)) {
+                return false;
+            }
+        }
+
+        ++m_lambda_depth;
+        const bool result = TraverseStmt(expr->getBody());
+        --m_lambda_depth;
+        return result;
+    }
+
+    /// Default member initializers and default arguments are evaluated where they're used,
+    /// but they aren't children of the using expressions
+    bool VisitCXXDefaultInitExpr(clang::CXXDefaultInitExpr * expr)
+    { return TraverseStmt(expr->getExpr()); }
+
+    bool VisitCXXDefaultArgExpr(clang::CXXDefaultArgExpr * expr)
+    { return TraverseStmt(expr->getExpr()); }
+
+    bool VisitCallExpr(clang::CallExpr * expr)
+    {
+        const auto * callee = expr->getDirectCallee();
+        add(expr, callee);
+        if (callsArguments(callee)) {
+            for (const auto * arg : expr->arguments()) {
+                addLambdaCalls(arg);
+            }
+        }
+        return true;
+    }
+
+    bool VisitCXXConstructExpr(clang::CXXConstructExpr * expr)
+    {
+        add(expr, expr->getConstructor());
+        return true;
+    }
+
+    bool VisitCXXNewExpr(clang::CXXNewExpr * expr)
+    {
+        add(expr, expr->getOperatorNew());
+        return true;
+    }
+
+    bool VisitCXXDeleteExpr(clang::CXXDeleteExpr * expr)
+    {
+        add(expr, expr->getOperatorDelete());
+        return true;
+    }
+
+    bool VisitCXXThrowExpr(clang::CXXThrowExpr * expr)
+    {
+        add(expr, nullptr);
+        return true;
+    }
+
+private:
+    void add(const clang::Expr * expr, const clang::FunctionDecl * callee)
+    { m_call_sites.push_back({expr, callee, m_try_depth > 0, m_lambda_depth > 0}); }
+
+    /// Calls of a lambda passed as an argument, written in place or as a local variable: the call sites
+    /// of the call operator (of every instantiation of a generic lambda) are reached through the argument
+    void addLambdaCalls(const clang::Expr * arg)
+    {
+        const auto * lambda_expr = arg->IgnoreImplicit();
+        if (const auto * ref = clang::dyn_cast<clang::DeclRefExpr>(lambda_expr)) {
+            const auto * var = clang::dyn_cast<clang::VarDecl>(ref->getDecl());
+            if (!var || !var->getInit() || !var->getType()->isRecordType()) {
+                return;
+            }
+            lambda_expr = var->getInit()->IgnoreImplicit();
+        }
+
+        const auto * lambda = clang::dyn_cast<clang::LambdaExpr>(lambda_expr);
+        if (!lambda) {
+            return;
+        }
+
+        const auto * call_operator = lambda->getCallOperator();
+        if (const auto * call_template = call_operator->getDescribedFunctionTemplate()) {
+            for (const auto * specialization : call_template->specializations()) {
+                add(arg, specialization);
+            }
+        } else {
+            add(arg, call_operator);
+        }
+    }
+
+private:
+    std::vector<CallSite> & m_call_sites;
+    unsigned m_try_depth = 0;
+    unsigned m_lambda_depth = 0;
+};
+
+} // namespace anonymous
+
+const std::vector<CallSite> & CallGraph::getCallSites(const clang::FunctionDecl * function)
+{
+    const auto [it, inserted] = m_call_sites.try_emplace(function);
+    if (!inserted) {
+        return it->second;
+    }
+
+    CallSiteCollector collector(it->second);
+    if (const auto * ctor = clang::dyn_cast<clang::CXXConstructorDecl>(function)) {
+        for (const auto * init : ctor->inits()) {
+            collector.TraverseStmt(init->getInit());
+        }
+    }
+    collector.TraverseStmt(function->getBody());
+
+    return it->second;
+}
+
+const clang::FunctionDecl * CallGraph::getFollowedDefinition(const clang::FunctionDecl * callee,
+                                                             const clang::SourceManager & source_manager)
+{
+    const clang::FunctionDecl * definition = nullptr;
+    if (!callee || !callee->hasBody(definition) || !definition) {
+        return nullptr;
+    }
+
+    if (isExpansionInSystemHeader(definition, source_manager)) {
+        return nullptr;
+    }
+
+    for (const auto * context = definition->getDeclContext(); context; context = context->getParent()) {
+        if (context->isStdNamespace()) {
+            return nullptr;
+        }
+    }
+    return definition;
+}
+
+} // namespace ica
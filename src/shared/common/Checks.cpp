@@ -122,7 +122,22 @@ const Check Checks::operator [] (const std::string_view check) const noexcept
 
 Check & Checks::get(const std::string_view check) noexcept
 {
-    return (check == "all") ? m_all : m_checks[check];
+    if (check == "all") {
+        m_has_all = true;
+        return m_all;
+    }
+    return m_checks[check];
+}
+
+void Checks::merge(const Checks & overrides)
+{
+    if (overrides.m_has_all) {
+        m_all = overrides.m_all;
+        m_has_all = true;
+    }
+    for (const auto & [check, state] : overrides.m_checks) {
+        m_checks[check] = state;
+    }
 }
 
 std::optional<std::string> Checks::parse(const std::string_view checks_list)
@@ -3,6 +3,10 @@
 #include "internal/util/RepoSpecific.h"
 #include <clang/AST/Expr.h>
 
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/Hashing.h"
+
 namespace ica {
 
 bool isIdenticalStmt(
@@ -183,6 +187,67 @@ bool isIdenticalStmt(
     }
 }
 
+std::size_t StructuralHasher::operator()(const clang::Stmt * stmt)
+{
+    using namespace clang;
+
+    if (!stmt) {
+        return 0;
+    }
+
+    if (const auto it = m_cache.find(stmt); it != m_cache.end()) {
+        return it->second;
+    }
+
+    // only properties compared by 'isIdenticalStmt' are mixed in, anything else could make
+    // identical statements hash differently
+    auto hash = llvm::hash_value(static_cast<unsigned>(stmt->getStmtClass()));
+
+    if (isa<Expr>(stmt)) {
+        for (const auto * child : stmt->children()) {
+            hash = llvm::hash_combine(hash, (*this)(child));
+        }
+    }
+
+    switch (stmt->getStmtClass()) {
+    default:
+        break;
+    case Stmt::CStyleCastExprClass:
+        hash = llvm::hash_combine(hash, cast<CStyleCastExpr>(stmt)->getTypeAsWritten().getAsOpaquePtr());
+        break;
+    case Stmt::CompoundStmtClass:
+        hash = llvm::hash_combine(hash, cast<CompoundStmt>(stmt)->size());
+        break;
+    case Stmt::CompoundAssignOperatorClass:
+    case Stmt::BinaryOperatorClass:
+        hash = llvm::hash_combine(hash, static_cast<unsigned>(cast<BinaryOperator>(stmt)->getOpcode()));
+        break;
+    case Stmt::CharacterLiteralClass:
+        hash = llvm::hash_combine(hash, cast<CharacterLiteral>(stmt)->getValue());
+        break;
+    case Stmt::DeclRefExprClass:
+        hash = llvm::hash_combine(hash, cast<DeclRefExpr>(stmt)->getDecl());
+        break;
+    case Stmt::IntegerLiteralClass:
+        hash = llvm::hash_combine(hash, cast<IntegerLiteral>(stmt)->getValue());
+        break;
+    case Stmt::FloatingLiteralClass:
+        hash = llvm::hash_combine(hash, cast<FloatingLiteral>(stmt)->getValue());
+        break;
+    case Stmt::StringLiteralClass:
+        hash = llvm::hash_combine(hash, cast<StringLiteral>(stmt)->getBytes());
+        break;
+    case Stmt::MemberExprClass:
+        hash = llvm::hash_combine(hash, cast<MemberExpr>(stmt)->getMemberDecl());
+        break;
+    case Stmt::UnaryOperatorClass:
+        hash = llvm::hash_combine(hash, static_cast<unsigned>(cast<UnaryOperator>(stmt)->getOpcode()));
+        break;
+    }
+
+    return m_cache[stmt] = hash;
+}
+
 
 std::string wrapCheckNameWithURL(const std::string_view check_name)
 {
@@ -306,4 +371,40 @@ RefTypeInfo isIterator(const clang::CXXRecordDecl *decl)
     return res;
 }
 
+bool isNoexcept(const clang::FunctionDecl * func_decl)
+{
+    auto ex_spec = func_decl->getExceptionSpecType();
+    return  ex_spec == clang::EST_DynamicNone ||
+            ex_spec == clang::EST_NoThrow ||
+            ex_spec == clang::EST_BasicNoexcept ||
+            ex_spec == clang::EST_DependentNoexcept ||
+            ex_spec >= clang::EST_NoexceptTrue; // NoexceptTrue < Unevaluated < Uninstantiated < Unparsed. We assume that all those will be evaluated to noexcept(true)
+}
+
+bool isAssert(const clang::FunctionDecl * func_decl)
+{
+    if (const auto * id = func_decl->getIdentifier()) {
+        return id->isStr("__assert_fail");
+    }
+    return false;
+}
+
+bool isStdReleasableLock(const clang::CXXRecordDecl * decl)
+{
+    if (!decl) {
+        return false;
+    }
+    const auto name = decl->getCanonicalDecl()->getQualifiedNameAsString();
+    return name == "std::unique_lock" || name == "std::shared_lock";
+}
+
+bool isStdLock(const clang::CXXRecordDecl * decl)
+{
+    if (!decl) {
+        return false;
+    }
+    const auto name = decl->getCanonicalDecl()->getQualifiedNameAsString();
+    return name == "std::lock_guard" || name == "std::scoped_lock" || isStdReleasableLock(decl);
+}
+
 } // namespace ica
@@ -1,10 +1,48 @@
 #include "shared/common/Config.h"
 #include "shared/common/Common.h"
+#include "shared/common/ConfigFile.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/DJB.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 
 #include <cstdlib>
 
 namespace ica {
 
+namespace {
+
+bool makeAbsolute(llvm::SmallVectorImpl<char> & path)
+{
+    if (llvm::sys::fs::make_absolute(path)) {
+        return false;
+    }
+    llvm::sys::path::remove_dots(path, /*remove_dot_dot=*/ true);
+    return true;
+}
+
+/// Path of the file relative to the root of its repository (the closest directory having '.git'),
+/// so that it doesn't depend on where the repository is checked out. The path as written otherwise
+std::string getRepositoryRelativePath(const llvm::StringRef file)
+{
+    llvm::SmallString<256> path(file);
+    if (!makeAbsolute(path)) {
+        return file.str();
+    }
+
+    for (auto directory = llvm::sys::path::parent_path(path); !directory.empty(); directory = llvm::sys::path::parent_path(directory)) {
+        llvm::SmallString<256> git(directory);
+        llvm::sys::path::append(git, ".git");
+        if (llvm::sys::fs::exists(git)) {
+            return llvm::sys::path::convert_to_slash(path.str().drop_front(directory.size()).ltrim("/\\"));
+        }
+    }
+    return file.str();
+}
+
+} // namespace anonymous
+
 Config::Config()
 {
     static constexpr const char * no_url_env = "ICA_NO_URL";
@@ -17,7 +55,16 @@ Config::Config()
 std::optional<std::string> Config::parse(const std::vector<std::string> & args)
 {
     const std::string_view checks_prefix = "checks=";
+    const std::string_view options_prefix = "options=";
+    const std::string_view budget_prefix = "budget-ms=";
+    const std::string_view sample_prefix = "sample=";
+    const std::string_view include_prefix = "include=";
+    const std::string_view exclude_prefix = "exclude=";
+    const std::string_view max_diags_prefix = "max-diags-per-file=";
+    const std::string_view mode_prefix = "mode=";
+    const std::string_view profile_prefix = "profile=";
     const std::string_view no_url = "no-url";
+    const std::string_view main_file_only = "main-file-only";
 
     for (const auto & arg : args) {
         if (arg == no_url) {
@@ -25,14 +72,117 @@ std::optional<std::string> Config::parse(const std::vector<std::string> & args)
             continue;
         }
 
+        if (arg == main_file_only) {
+            m_main_file_only = true;
+            continue;
+        }
+
         if (const auto [starts_with, check_list] = removePrefix(arg, checks_prefix); starts_with) {
             if (auto error = m_checks.parse(check_list); error) {
                 return error;
             }
+            continue;
+        }
+
+        if (const auto [starts_with, options_list] = removePrefix(arg, options_prefix); starts_with) {
+            if (auto error = m_options.parse(options_list); error) {
+                return error;
+            }
+            continue;
+        }
+
+        if (const auto [starts_with, budget] = removePrefix(arg, budget_prefix); starts_with) {
+            unsigned budget_ms = 0;
+            if (llvm::StringRef(budget.data(), budget.size()).getAsInteger(10, budget_ms) || budget_ms == 0) {
+                return "Can't parse '" + arg + "': expected a positive number of milliseconds";
+            }
+            m_budget = std::chrono::milliseconds(budget_ms);
+            continue;
+        }
+
+        if (const auto [starts_with, sample] = removePrefix(arg, sample_prefix); starts_with) {
+            const auto [bucket, buckets] = llvm::StringRef(sample.data(), sample.size()).split('/');
+            unsigned bucket_num = 0;
+            unsigned buckets_num = 0;
+            if (bucket.getAsInteger(10, bucket_num) || buckets.getAsInteger(10, buckets_num) || bucket_num >= buckets_num) {
+                return "Can't parse '" + arg + "': expected 'sample=k/n' with 0 <= k < n";
+            }
+            m_sample = Sample{bucket_num, buckets_num};
+            continue;
+        }
+
+        if (const auto [starts_with, globs] = removePrefix(arg, include_prefix); starts_with) {
+            if (auto error = m_file_filter.parseInclude(globs); error) {
+                return error;
+            }
+            continue;
         }
+
+        if (const auto [starts_with, globs] = removePrefix(arg, exclude_prefix); starts_with) {
+            if (auto error = m_file_filter.parseExclude(globs); error) {
+                return error;
+            }
+            continue;
+        }
+
+        if (const auto [starts_with, max_diags] = removePrefix(arg, max_diags_prefix); starts_with) {
+            unsigned max_diags_num = 0;
+            if (llvm::StringRef(max_diags.data(), max_diags.size()).getAsInteger(10, max_diags_num)) {
+                return "Can't parse '" + arg + "': expected a number of diagnostics";
+            }
+            m_max_diags_per_file = max_diags_num;
+            continue;
+        }
+
+        if (const auto [starts_with, mode] = removePrefix(arg, mode_prefix); starts_with) {
+            if (mode == "add") {
+                m_mode = Mode::Add;
+            } else if (mode == "replace") {
+                m_mode = Mode::Replace;
+            } else {
+                return "Can't parse '" + arg + "': expected 'mode=add' or 'mode=replace'";
+            }
+            continue;
+        }
+
+        if (const auto [starts_with, path] = removePrefix(arg, profile_prefix); starts_with) {
+            const auto & profile_file = getProfileFile(llvm::StringRef(path.data(), path.size()));
+            if (profile_file.error) {
+                return profile_file.error;
+            }
+            m_profile = &profile_file.profile;
+            continue;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::string> Config::loadConfigFiles(const llvm::StringRef main_file)
+{
+    llvm::SmallString<256> path(main_file);
+    if (!makeAbsolute(path)) {
+        return std::nullopt; // can't locate the file, so there are no config files to look for
+    }
+
+    const auto & directory_config = getDirectoryConfig(llvm::sys::path::parent_path(path));
+    if (directory_config.error) {
+        return directory_config.error;
     }
 
+    m_checks.merge(directory_config.checks);
+    m_options.merge(directory_config.options);
     return std::nullopt;
 }
 
+bool Config::isSampled(const llvm::StringRef main_file) const
+{
+    if (!m_sample) {
+        return true;
+    }
+
+    // djbHash is stable across runs and platforms, unlike std::hash
+    return llvm::djbHash(getRepositoryRelativePath(main_file)) % m_sample->buckets == m_sample->bucket;
+}
+
 } // namespace ica
@@ -0,0 +1,164 @@
+#include "shared/common/ConfigFile.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/YAMLParser.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+
+namespace ica {
+
+namespace {
+
+constexpr auto * config_file_name = ".ica.yaml";
+
+struct ConfigFile
+{
+    std::string checks;
+    std::string options;
+    bool inherit_parent = true;
+};
+
+void storeFirstYAMLError(const llvm::SMDiagnostic & diag, void * context)
+{
+    auto & error = *static_cast<std::optional<std::string> *>(context);
+    if (!error) {
+        error = diag.getMessage().str();
+    }
+}
+
+std::optional<std::string> parseConfigFile(const llvm::StringRef content, ConfigFile & config_file)
+{
+    std::optional<std::string> error;
+
+    llvm::SourceMgr source_manager;
+    source_manager.setDiagHandler(storeFirstYAMLError, &error);
+
+    llvm::yaml::Stream stream(content, source_manager);
+    auto document = stream.begin();
+    if (document == stream.end()) {
+        return error;
+    }
+
+    auto * root = document->getRoot();
+    if (!root || llvm::isa<llvm::yaml::NullNode>(root)) {
+        return error;
+    }
+
+    auto * mapping = llvm::dyn_cast<llvm::yaml::MappingNode>(root);
+    if (!mapping) {
+        return std::string("expected a mapping of settings");
+    }
+
+    for (auto & key_value : *mapping) {
+        const auto * key = llvm::dyn_cast_or_null<llvm::yaml::ScalarNode>(key_value.getKey());
+        const auto * value = llvm::dyn_cast_or_null<llvm::yaml::ScalarNode>(key_value.getValue());
+        if (!key || !value) {
+            return error ? error : std::string("expected 'Setting: value' pairs");
+        }
+
+        llvm::SmallString<32> key_storage;
+        llvm::SmallString<128> value_storage;
+        const auto name = key->getValue(key_storage);
+        const auto setting = value->getValue(value_storage);
+
+        if (name == "Checks") {
+            config_file.checks = setting.str();
+        } else if (name == "Options") {
+            config_file.options = setting.str();
+        } else if (name == "InheritParentConfig") {
+            if (setting != "true" && setting != "false") {
+                return "'InheritParentConfig' expects 'true' or 'false', got '" + setting.str() + "'";
+            }
+            config_file.inherit_parent = (setting == "true");
+        } else {
+            return "unknown setting '" + name.str() + "'";
+        }
+    }
+
+    return error;
+}
+
+class DirectoryConfigCache
+{
+public:
+    const DirectoryConfig & get(const llvm::StringRef directory)
+    {
+        std::lock_guard lock(m_mutex);
+        return getUnlocked(directory);
+    }
+
+private:
+    const DirectoryConfig & getUnlocked(const llvm::StringRef directory)
+    {
+        if (const auto it = m_configs.find(directory.str()); it != m_configs.end()) {
+            return *it->second;
+        }
+
+        auto config = std::make_unique<DirectoryConfig>();
+
+        llvm::SmallString<256> path(directory);
+        llvm::sys::path::append(path, config_file_name);
+
+        ConfigFile config_file;
+        bool has_config_file = false;
+        std::optional<std::string> error;
+
+        if (auto buffer = llvm::MemoryBuffer::getFile(path); buffer) {
+            has_config_file = true;
+            error = parseConfigFile((*buffer)->getBuffer(), config_file);
+        } else if (buffer.getError() != std::errc::no_such_file_or_directory) {
+            error = "can't read: " + buffer.getError().message();
+        }
+
+        const auto parent = llvm::sys::path::parent_path(directory);
+        if (config_file.inherit_parent && !parent.empty() && parent != directory) {
+            const auto & parent_config = getUnlocked(parent);
+            config->checks = parent_config.checks;
+            config->options = parent_config.options;
+            config->error = parent_config.error;
+        }
+
+        if (has_config_file && !error) {
+            // parsed checks refer to the list, so it's kept for the process lifetime
+            const auto & checks_list = m_checks_lists.emplace_back(std::move(config_file.checks));
+
+            Checks own_checks;
+            error = own_checks.parse(checks_list);
+            config->checks.merge(own_checks);
+
+            Options own_options;
+            if (!error) {
+                error = own_options.parse(config_file.options);
+            }
+            config->options.merge(own_options);
+        }
+
+        if (error) {
+            config->error = std::string(path.str()) + ": " + *error;
+        }
+
+        return *m_configs.emplace(directory.str(), std::move(config)).first->second;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<DirectoryConfig>> m_configs;
+    std::deque<std::string> m_checks_lists;
+};
+
+} // namespace anonymous
+
+const DirectoryConfig & getDirectoryConfig(const llvm::StringRef directory)
+{
+    static DirectoryConfigCache cache;
+    return cache.get(directory);
+}
+
+} // namespace ica
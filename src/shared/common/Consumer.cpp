@@ -1,42 +1,230 @@
 #include "shared/common/Consumer.h"
 #include "shared/common/Common.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace ica {
 
+namespace {
+
+/// Implicit instantiation made by the translation unit of a template loaded from a PCH or a module.
+/// Such templates aren't traversed, so neither are their instantiations, unless they're handled separately.
+/// Members of class template specializations are reached through the specialization
+bool isASTFileTemplateInstantiation(const clang::Decl * decl)
+{
+    if (decl->isFromASTFile()) {
+        return false;
+    }
+
+    if (const auto * specialization = clang::dyn_cast<clang::ClassTemplateSpecializationDecl>(decl)) {
+        return specialization->getTemplateSpecializationKind() == clang::TSK_ImplicitInstantiation
+            && specialization->getSpecializedTemplate()->isFromASTFile();
+    }
+
+    if (const auto * function = clang::dyn_cast<clang::FunctionDecl>(decl)) {
+        if (const auto * primary_template = function->getPrimaryTemplate()) {
+            return primary_template->isFromASTFile();
+        }
+        // member of a class template specialization, which is instantiated by the AST file itself
+        const auto * record = clang::dyn_cast<clang::CXXRecordDecl>(function->getDeclContext());
+        return record && record->isFromASTFile();
+    }
+
+    return false;
+}
+
+} // namespace anonymous
+
 Consumer::Consumer(clang::CompilerInstance & ci, Config config) :
     m_config(std::move(config)),
+    m_diag(ci.getDiagnostics()),
     m_translation_unit_visitor(ci, m_config),
-    m_top_level_decl_visitor(ci, m_config)
+    m_top_level_decl_visitor(ci, m_config),
+    m_effect_summaries(ci.getSourceManager())
 {
+    m_translation_unit_visitor.setEffectSummaries(&m_effect_summaries);
+    m_top_level_decl_visitor.setEffectSummaries(&m_effect_summaries);
+
+    if (LocationFilter::isNeeded(m_config)) {
+        m_location_filter.emplace(m_config, ci.getSourceManager());
+        m_translation_unit_visitor.setLocationFilter(&*m_location_filter);
+        m_top_level_decl_visitor.setLocationFilter(&*m_location_filter);
+    }
+
+    if (const auto max_diags = m_config.get_max_diags_per_file(); max_diags) {
+        m_diagnostic_limiter.emplace(*max_diags, ci.getSourceManager());
+        m_translation_unit_visitor.setDiagnosticLimiter(&*m_diagnostic_limiter);
+        m_top_level_decl_visitor.setDiagnosticLimiter(&*m_diagnostic_limiter);
+    }
+
+    if (ProfileFilter::isNeeded(m_config)) {
+        m_profile_filter.emplace(m_config, ci.getSourceManager());
+        m_translation_unit_visitor.setProfileFilter(&*m_profile_filter);
+        m_top_level_decl_visitor.setProfileFilter(&*m_profile_filter);
+    }
+
+    if (const auto budget = m_config.get_budget(); budget) {
+        m_budget.emplace(*budget);
+        m_translation_unit_visitor.enableTiming();
+        m_top_level_decl_visitor.enableTiming();
+
+        // a single top level declaration (e.g. a namespace wrapping the file) may take the whole budget
+        const auto checkpoint = [this] {
+            m_budget->stop();
+            checkBudget();
+            m_budget->start();
+        };
+        m_translation_unit_visitor.setCheckpoint(checkpoint);
+        m_top_level_decl_visitor.setCheckpoint(checkpoint);
+    }
+}
+
+llvm::ArrayRef<OptionDeclaration> Consumer::getOptionDeclarations()
+{
+    static const auto declarations = [] {
+        std::vector<OptionDeclaration> result(std::begin(ProfileFilter::option_declarations), std::end(ProfileFilter::option_declarations));
+        TranslationUnitUV::collectOptionDeclarations(result);
+        TopLevelDeclUV::collectOptionDeclarations(result);
+        return result;
+    }();
+    return declarations;
 }
 
 void Consumer::HandleTranslationUnit(clang::ASTContext & context)
 {
+    // function templates are instantiated at the end of the translation unit, after the last top level declaration
+    if (m_top_level_decl_visitor.shouldVisitTemplateInstantiations()) {
+        for (auto * decl : m_ast_file_instantiations) {
+            traverseTopLevelDecl(decl);
+        }
+    }
+
+    if (m_top_level_decl_visitor.isEnabled()) {
+        m_top_level_decl_visitor.setContext(context);
+        m_top_level_decl_visitor.finishTranslationUnit(context);
+    }
+
     if (m_translation_unit_visitor.isEnabled()) {
+        if (m_budget) {
+            m_budget->start();
+        }
+
+        m_translation_unit_visitor.updateTriggered(context.Idents);
         m_translation_unit_visitor.setContext(context);
-        m_translation_unit_visitor.TraverseDecl(context.getTranslationUnitDecl());
+        m_translation_unit_visitor.traverseTranslationUnit(context, m_ast_file_instantiations);
         m_translation_unit_visitor.printDiagnostic(context);
+
+        if (m_budget) {
+            m_budget->stop();
+        }
     }
 
+    if (m_diagnostic_limiter) {
+        m_diagnostic_limiter->reportSuppressed(m_diag);
+    }
+    reportSkippedChecks();
 }
 
 bool Consumer::HandleTopLevelDecl(clang::DeclGroupRef decl_group)
 {
     for (const auto decl : decl_group) {
-        auto & context = decl->getASTContext();
-        auto & source_manager = context.getSourceManager();
-
-        if (shouldProcessDecl(decl, source_manager)) {
-            if (m_top_level_decl_visitor.isEnabled()) {
-                m_top_level_decl_visitor.clear();
-                m_top_level_decl_visitor.setContext(context);
-                m_top_level_decl_visitor.TraverseDecl(decl);
-                m_top_level_decl_visitor.printDiagnostic(context);
-            }
+        // recorded for every declaration: translation unit checks report at the end of the file
+        if (m_profile_filter) {
+            m_profile_filter->addFunctions(decl);
         }
+
+        traverseTopLevelDecl(decl);
     }
 
     return true;
 }
 
+void Consumer::HandleTagDeclDefinition(clang::TagDecl * decl)
+{
+    if (isASTFileTemplateInstantiation(decl)) {
+        m_ast_file_instantiations.push_back(decl);
+    }
+}
+
+void Consumer::HandleCXXImplicitFunctionInstantiation(clang::FunctionDecl * decl)
+{
+    if (isASTFileTemplateInstantiation(decl)) {
+        m_ast_file_instantiations.push_back(decl);
+    }
+}
+
+void Consumer::traverseTopLevelDecl(clang::Decl * decl)
+{
+    auto & context = decl->getASTContext();
+    auto & source_manager = context.getSourceManager();
+
+    if (!decl->isFromASTFile() && shouldProcessDecl(decl, source_manager)
+            && (!m_location_filter || m_location_filter->shouldVisit(decl))) {
+        if (m_top_level_decl_visitor.isEnabled()) {
+            if (m_budget) {
+                m_budget->start();
+            }
+
+            m_top_level_decl_visitor.updateTriggered(context.Idents);
+            m_top_level_decl_visitor.clear();
+            m_top_level_decl_visitor.setContext(context);
+            m_top_level_decl_visitor.TraverseDecl(decl);
+            m_top_level_decl_visitor.printDiagnostic(context);
+
+            if (m_budget) {
+                m_budget->stop();
+                checkBudget();
+            }
+        }
+    }
+}
+
+void Consumer::checkBudget()
+{
+    if (!m_budget || !m_budget->isExceeded()) {
+        return;
+    }
+
+    std::vector<VisitorBase *> visitors;
+    m_translation_unit_visitor.collectEnabledVisitors(visitors);
+    m_top_level_decl_visitor.collectEnabledVisitors(visitors);
+
+    const auto most_expensive = std::max_element(visitors.begin(), visitors.end(),
+            [] (const auto * l, const auto * r) { return l->getSpentTime() < r->getSpentTime(); });
+    if (most_expensive == visitors.end()) {
+        return;
+    }
+
+    const auto check_names = (*most_expensive)->getEnabledCheckNames();
+    m_skipped_checks.insert(m_skipped_checks.end(), check_names.begin(), check_names.end());
+
+    (*most_expensive)->skip();
+    m_translation_unit_visitor.updateTraversalFlags();
+    m_top_level_decl_visitor.updateTraversalFlags();
+
+    m_budget->extend();
+}
+
+void Consumer::reportSkippedChecks()
+{
+    if (m_skipped_checks.empty()) {
+        return;
+    }
+
+    std::string check_list;
+    for (const auto check_name : m_skipped_checks) {
+        if (!check_list.empty()) {
+            check_list += ", ";
+        }
+        check_list += check_name;
+    }
+
+    const auto diag_id = m_diag.getDiagnosticIDs()->getCustomDiagID(clang::DiagnosticIDs::Remark,
+            "ICA time budget of %0 ms is exceeded, skipped checks for the rest of the file: %1");
+    report(m_diag, diag_id)
+        .AddValue(static_cast<unsigned>(m_budget->getBudget().count()))
+        .AddValue(check_list);
+}
+
 } // namespace ica
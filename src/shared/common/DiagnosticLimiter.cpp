@@ -0,0 +1,41 @@
+#include "shared/common/DiagnosticLimiter.h"
+#include "shared/common/DiagnosticsBuilder.h"
+
+#include "clang/Basic/FileManager.h"
+
+namespace ica {
+
+bool DiagnosticLimiter::shouldReport(const clang::SourceLocation loc, const std::string_view check_name)
+{
+    if (loc.isInvalid()) {
+        return true;
+    }
+
+    const auto file_id = m_source_manager.getFileID(m_source_manager.getExpansionLoc(loc));
+    const auto count = ++m_counts[{file_id, check_name}];
+
+    return count <= m_max_per_file;
+}
+
+void DiagnosticLimiter::reportSuppressed(clang::DiagnosticsEngine & diag) const
+{
+    const auto diag_id = diag.getDiagnosticIDs()->getCustomDiagID(clang::DiagnosticIDs::Remark,
+            "%0 more %1 diagnostics suppressed in %2 (max-diags-per-file=%3)");
+
+    for (const auto & [file_and_check, count] : m_counts) {
+        if (count <= m_max_per_file) {
+            continue;
+        }
+
+        const auto & [file_id, check_name] = file_and_check;
+        const auto * file_entry = m_source_manager.getFileEntryForID(file_id);
+
+        report(diag, m_source_manager.getLocForStartOfFile(file_id), diag_id)
+            .AddValue(count - m_max_per_file)
+            .AddValue(llvm::StringRef(check_name.data(), check_name.size()))
+            .AddValue(file_entry ? file_entry->getName() : llvm::StringRef("<unknown>"))
+            .AddValue(m_max_per_file);
+    }
+}
+
+} // namespace ica
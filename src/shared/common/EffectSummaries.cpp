@@ -0,0 +1,100 @@
+#include "shared/common/EffectSummaries.h"
+#include "shared/common/Common.h"
+
+#include "clang/AST/ExprCXX.h"
+
+#include "llvm/ADT/DenseSet.h"
+
+namespace ica {
+
+bool EffectSummaries::hasDirectEffect(const CallSite & site, const Effect effect)
+{
+    // 'std::bad_alloc' isn't a throw on the hot path (it's an allocation there), but it does make the function throwing
+    if (const auto * new_expr = clang::dyn_cast<clang::CXXNewExpr>(site.expr); new_expr && effect == Effect::Throw) {
+        return new_expr->getOperatorNew() && !isNoexcept(new_expr->getOperatorNew());
+    }
+    return getDirectEffect(site, effect).has_value();
+}
+
+std::vector<const clang::FunctionDecl *> EffectSummaries::collectUnsummarized(const clang::FunctionDecl * definition, const Effect effect)
+{
+    const auto & summaries = m_summaries[static_cast<std::size_t>(effect)];
+
+    std::vector<const clang::FunctionDecl *> result;
+    llvm::DenseSet<const clang::FunctionDecl *> visited;
+    std::vector<const clang::FunctionDecl *> stack{definition};
+    visited.insert(definition);
+
+    while (!stack.empty()) {
+        const auto * function = stack.back();
+        stack.pop_back();
+        result.push_back(function);
+
+        for (const auto & site : m_call_graph.getCallSites(function)) {
+            if (!reachesCaller(site, effect)) {
+                continue;
+            }
+            const auto * callee = CallGraph::getFollowedDefinition(site.callee, m_source_manager);
+            if (callee && !summaries.count(callee) && visited.insert(callee).second) {
+                stack.push_back(callee);
+            }
+        }
+    }
+    return result;
+}
+
+bool EffectSummaries::mayHave(const clang::FunctionDecl * function, const Effect effect)
+{
+    const auto * definition = CallGraph::getFollowedDefinition(function, m_source_manager);
+    if (!definition) {
+        return false;
+    }
+
+    auto & summaries = m_summaries[static_cast<std::size_t>(effect)];
+    if (const auto it = summaries.find(definition); it != summaries.end()) {
+        return it->second;
+    }
+
+    // the functions reachable from 'definition' are either summarized already or collected here,
+    // so the least fixed point over them is final
+    const auto functions = collectUnsummarized(definition, effect);
+    for (const auto * f : functions) {
+        bool has_effect = false;
+        for (const auto & site : m_call_graph.getCallSites(f)) {
+            if (reachesCaller(site, effect) && hasDirectEffect(site, effect)) {
+                has_effect = true;
+                break;
+            }
+        }
+        summaries[f] = has_effect;
+    }
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto * f : functions) {
+            if (summaries[f]) {
+                continue;
+            }
+            for (const auto & site : m_call_graph.getCallSites(f)) {
+                if (!reachesCaller(site, effect)) {
+                    continue;
+                }
+                const auto * callee = CallGraph::getFollowedDefinition(site.callee, m_source_manager);
+                if (callee && summaries.lookup(callee)) {
+                    summaries[f] = true;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return summaries[definition];
+}
+
+bool EffectSummaries::mayHave(const CallSite & site, const Effect effect)
+{
+    return reachesCaller(site, effect) && (hasDirectEffect(site, effect) || mayHave(site.callee, effect));
+}
+
+} // namespace ica
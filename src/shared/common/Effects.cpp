@@ -0,0 +1,395 @@
+#include "shared/common/Effects.h"
+#include "shared/common/Common.h"
+
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/ExprCXX.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
+
+namespace ica {
+
+namespace {
+
+bool isInStd(const clang::Decl * decl)
+{
+    for (const auto * context = decl->getDeclContext(); context; context = context->getParent()) {
+        if (context->isStdNamespace()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isGlobalOrStd(const clang::FunctionDecl * function)
+{
+    const auto * context = function->getDeclContext()->getRedeclContext();
+    return context->isTranslationUnit() || context->isStdNamespace();
+}
+
+/// Name of a class template of namespace std, e.g. 'vector' for 'std::vector<int>', empty for other classes
+llvm::StringRef getStdClassName(const clang::CXXRecordDecl * record)
+{
+    if (!record || !record->getIdentifier() || !record->isInStdNamespace()) {
+        return {};
+    }
+    return record->getName();
+}
+
+/// 'std::function(nullptr_t)', 'std::function::operator = (nullptr_t)'
+bool hasNullptrParameter(const clang::FunctionDecl * function)
+{
+    return function->getNumParams() == 1 && function->getParamDecl(0)->getType()->isNullPtrType();
+}
+
+/// 'std::string' for 'basic_string', 'std::ofstream' for 'basic_ofstream'
+std::string getStdClassDisplayName(llvm::StringRef name)
+{
+    name.consume_front("basic_");
+    return "std::" + name.str();
+}
+
+std::optional<std::string> getAllocation(const CallSite & site)
+{
+    if (const auto * new_expr = clang::dyn_cast<clang::CXXNewExpr>(site.expr)) {
+        if (site.callee && site.callee->isReservedGlobalPlacementOperator()) {
+            return std::nullopt;
+        }
+        return std::string(new_expr->isArray() ? "operator new[]" : "operator new");
+    }
+
+    const auto * callee = site.callee;
+    if (!callee) {
+        return std::nullopt;
+    }
+
+    if (const auto * ctor = clang::dyn_cast<clang::CXXConstructorDecl>(callee)) {
+        if (ctor->isDefaultConstructor() || ctor->isMoveConstructor() || hasNullptrParameter(ctor)) {
+            return std::nullopt;
+        }
+        const auto class_name = getStdClassName(ctor->getParent());
+        if (class_name == "basic_string" || class_name == "vector" || class_name == "function") {
+            return getStdClassDisplayName(class_name) + " constructor";
+        }
+        return std::nullopt;
+    }
+
+    if (const auto * method = clang::dyn_cast<clang::CXXMethodDecl>(callee)) {
+        const auto class_name = getStdClassName(method->getParent());
+        if (class_name.empty()) {
+            return std::nullopt;
+        }
+
+        const auto method_name = method->getNameAsString();
+        const bool grows = llvm::StringSwitch<bool>(method_name)
+            .Cases("push_back", "emplace_back", "insert", "emplace", "resize", "reserve", "assign", true)
+            .Cases("append", "replace", "operator+=", class_name == "basic_string")
+            .Case("operator=", method->isCopyAssignmentOperator())
+            .Default(false);
+
+        const bool assigns_callable = class_name == "function" && method_name == "operator="
+            && !method->isMoveAssignmentOperator() && !hasNullptrParameter(method);
+
+        if ((grows && (class_name == "basic_string" || class_name == "vector")) || assigns_callable) {
+            return getStdClassDisplayName(class_name) + "::" + method_name;
+        }
+        return std::nullopt;
+    }
+
+    const auto name = callee->getDeclName();
+    if (name.getCXXOverloadedOperator() == clang::OO_New || name.getCXXOverloadedOperator() == clang::OO_Array_New) {
+        if (!callee->isReservedGlobalPlacementOperator()) {
+            return name.getAsString();
+        }
+        return std::nullopt;
+    }
+
+    // 'std::string operator + (...)'
+    if (name.getCXXOverloadedOperator() == clang::OO_Plus && isInStd(callee)
+            && getStdClassName(callee->getReturnType()->getAsCXXRecordDecl()) == "basic_string") {
+        return std::string("std::string operator+");
+    }
+
+    if (!callee->getIdentifier() || !isGlobalOrStd(callee)) {
+        return std::nullopt;
+    }
+
+    const bool allocates = llvm::StringSwitch<bool>(callee->getName())
+        .Cases("malloc", "calloc", "realloc", "aligned_alloc", "strdup", "strndup", true)
+        .Cases("make_shared", "make_unique", "allocate_shared", isInStd(callee))
+        .Default(false);
+
+    if (allocates) {
+        return (isInStd(callee) ? "std::" : "") + callee->getName().str();
+    }
+    return std::nullopt;
+}
+
+bool isInStdNamespace(const clang::FunctionDecl * function, const llvm::StringRef nested_namespace)
+{
+    const auto * ns = clang::dyn_cast<clang::NamespaceDecl>(function->getDeclContext()->getRedeclContext());
+    return ns && ns->getIdentifier() && ns->getName() == nested_namespace
+        && ns->getDeclContext()->getRedeclContext()->isStdNamespace();
+}
+
+/// 'std::cout', 'std::cerr', 'std::clog' and their wide variants
+std::optional<std::string> getStdStandardStream(const clang::Expr * expr)
+{
+    if (!expr) {
+        return std::nullopt;
+    }
+    const auto * ref = clang::dyn_cast<clang::DeclRefExpr>(expr->IgnoreParenImpCasts());
+    const auto * var = ref ? clang::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+    if (!var || !var->getIdentifier() || !var->isInStdNamespace()) {
+        return std::nullopt;
+    }
+
+    const bool is_stream = llvm::StringSwitch<bool>(var->getName())
+        .Cases("cout", "cerr", "clog", "wcout", "wcerr", "wclog", true)
+        .Default(false);
+    if (is_stream) {
+        return "std::" + var->getName().str();
+    }
+    return std::nullopt;
+}
+
+/// 'std::ofstream', 'std::ifstream', 'std::fstream' or a standard stream, which the call writes to or reads from
+std::optional<std::string> getStreamIO(const CallSite & site)
+{
+    const clang::Expr * stream = nullptr;
+    if (const auto * member_call = clang::dyn_cast<clang::CXXMemberCallExpr>(site.expr)) {
+        const auto * method = member_call->getMethodDecl();
+        const bool does_io = method && method->getIdentifier() && llvm::StringSwitch<bool>(method->getName())
+            .Cases("write", "put", "flush", "read", "get", "getline", "ignore", "open", "close", true)
+            .Default(false);
+        if (does_io) {
+            stream = member_call->getImplicitObjectArgument();
+        }
+    } else if (const auto * operator_call = clang::dyn_cast<clang::CXXOperatorCallExpr>(site.expr)) {
+        const auto op = operator_call->getOperator();
+        if ((op == clang::OO_LessLess || op == clang::OO_GreaterGreater) && operator_call->getNumArgs() == 2) {
+            stream = operator_call->getArg(0);
+        }
+    } else if (const auto * construct = clang::dyn_cast<clang::CXXConstructExpr>(site.expr)) {
+        // opening a file
+        if (construct->getNumArgs() > 0 && !construct->getConstructor()->isCopyOrMoveConstructor()) {
+            const auto class_name = getStdClassName(construct->getConstructor()->getParent());
+            if (class_name == "basic_ofstream" || class_name == "basic_ifstream" || class_name == "basic_fstream") {
+                return getStdClassDisplayName(class_name) + " constructor";
+            }
+        }
+        return std::nullopt;
+    }
+
+    if (!stream) {
+        return std::nullopt;
+    }
+    if (auto standard_stream = getStdStandardStream(stream); standard_stream) {
+        return standard_stream;
+    }
+
+    const auto class_name = getStdClassName(stream->IgnoreParenImpCasts()->getType()->getAsCXXRecordDecl());
+    if (class_name == "basic_ofstream" || class_name == "basic_ifstream" || class_name == "basic_fstream") {
+        return getStdClassDisplayName(class_name);
+    }
+    return std::nullopt;
+}
+
+/// 'std::defer_lock', 'std::try_to_lock', 'std::adopt_lock' constructors don't lock a mutex
+bool hasLockTagParameter(const clang::CXXConstructorDecl * ctor)
+{
+    for (const auto * param : ctor->parameters()) {
+        const auto tag = getStdClassName(param->getType()->getAsCXXRecordDecl());
+        if (tag == "defer_lock_t" || tag == "try_to_lock_t" || tag == "adopt_lock_t") {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<std::string> getBlocking(const CallSite & site)
+{
+    if (auto stream = getStreamIO(site); stream) {
+        return stream;
+    }
+
+    const auto * callee = site.callee;
+    if (!callee) {
+        return std::nullopt;
+    }
+
+    if (const auto * ctor = clang::dyn_cast<clang::CXXConstructorDecl>(callee)) {
+        if (ctor->getNumParams() > 0 && !ctor->isCopyOrMoveConstructor() && !hasLockTagParameter(ctor)
+                && isStdLock(ctor->getParent())) {
+            return getStdClassDisplayName(ctor->getParent()->getName()) + " constructor";
+        }
+        return std::nullopt;
+    }
+
+    if (const auto * method = clang::dyn_cast<clang::CXXMethodDecl>(callee)) {
+        const auto class_name = getStdClassName(method->getParent());
+        if (class_name.empty() || !method->getIdentifier()) {
+            return std::nullopt;
+        }
+
+        const auto method_name = method->getName();
+        const bool is_lock = llvm::StringSwitch<bool>(method_name)
+            .Cases("lock", "lock_shared", "try_lock_for", "try_lock_until", true)
+            .Cases("try_lock_shared_for", "try_lock_shared_until", true)
+            .Default(false);
+        const bool is_wait = llvm::StringSwitch<bool>(method_name)
+            .Cases("wait", "wait_for", "wait_until", true)
+            .Default(false);
+
+        const bool blocks = llvm::StringSwitch<bool>(class_name)
+            .Cases("mutex", "timed_mutex", "recursive_mutex", "recursive_timed_mutex", is_lock)
+            .Cases("shared_mutex", "shared_timed_mutex", is_lock)
+            .Cases("unique_lock", "shared_lock", is_lock)
+            .Cases("condition_variable", "condition_variable_any", is_wait)
+            .Cases("future", "shared_future", is_wait || method_name == "get")
+            .Case("thread", method_name == "join")
+            .Default(false);
+
+        if (blocks) {
+            return getStdClassDisplayName(class_name) + "::" + method_name.str();
+        }
+        return std::nullopt;
+    }
+
+    if (!callee->getIdentifier()) {
+        return std::nullopt;
+    }
+
+    if (isInStdNamespace(callee, "this_thread")) {
+        if (callee->getName() == "sleep_for" || callee->getName() == "sleep_until") {
+            return "std::this_thread::" + callee->getName().str();
+        }
+        return std::nullopt;
+    }
+
+    if (!isGlobalOrStd(callee)) {
+        return std::nullopt;
+    }
+
+    if (isInStd(callee)) {
+        if (callee->getName() == "lock") {
+            return std::string("std::lock");
+        }
+        return std::nullopt;
+    }
+
+    const bool blocks = llvm::StringSwitch<bool>(callee->getName())
+        .Cases("fopen", "fclose", "fread", "fwrite", "fflush", "fgets", "fputs", true)
+        .Cases("printf", "fprintf", "puts", "perror", true)
+        .Cases("open", "close", "read", "write", "pread", "pwrite", "fsync", true)
+        .Cases("send", "sendto", "sendmsg", "recv", "recvfrom", "recvmsg", "connect", "accept", true)
+        .Cases("poll", "select", "epoll_wait", true)
+        .Cases("sleep", "usleep", "nanosleep", true)
+        .Cases("syslog", "vsyslog", true)
+        .Cases("pthread_mutex_lock", "pthread_cond_wait", "pthread_join", true)
+        .Default(false);
+
+    if (blocks) {
+        return callee->getName().str();
+    }
+    return std::nullopt;
+}
+
+/// Special members which are defaulted without an exception specification are noexcept
+/// if all the members are, which is rather checked in the members themselves
+bool isDefaultedWithoutSpec(const clang::FunctionDecl * function)
+{
+    return function->isDefaulted() && function->getExceptionSpecType() == clang::EST_None;
+}
+
+std::optional<std::string> getThrow(const CallSite & site)
+{
+    if (const auto * throw_expr = clang::dyn_cast<clang::CXXThrowExpr>(site.expr)) {
+        return std::string(throw_expr->getSubExpr() ? "throw" : "rethrow");
+    }
+
+    const auto * callee = site.callee;
+    // 'std::bad_alloc' of a new expression is left to hot-path-allocation
+    if (!callee || clang::isa<clang::CXXNewExpr>(site.expr)
+            || isNoexcept(callee) || isAssert(callee) || isDefaultedWithoutSpec(callee)
+            || clang::isa<clang::CXXDestructorDecl>(callee)) {
+        return std::nullopt;
+    }
+
+    if (isInStd(callee)) {
+        // functions of namespace std are not followed, only the ones known to throw on bad input are reported,
+        // while 'std::bad_alloc' of the allocating ones is not: it would be almost every function of std
+        if (const auto * method = clang::dyn_cast<clang::CXXMethodDecl>(callee)) {
+            const auto class_name = getStdClassName(method->getParent());
+            if (class_name.empty()) {
+                return std::nullopt;
+            }
+
+            const bool throws = method->getIdentifier() && llvm::StringSwitch<bool>(method->getName())
+                .Case("at", true)
+                .Case("reserve", class_name == "vector" || class_name == "basic_string")
+                .Case("value", class_name == "optional")
+                .Default(false);
+            const bool calls_function = class_name == "function" && method->getOverloadedOperator() == clang::OO_Call;
+
+            if (throws || calls_function) {
+                return getStdClassDisplayName(class_name) + "::" + method->getNameAsString();
+            }
+            return std::nullopt;
+        }
+
+        if (!callee->getIdentifier()) {
+            return std::nullopt;
+        }
+        // 'std::get' of tuple, pair and array never throws, only the one of variant
+        const bool is_variant_get = callee->getNumParams() == 1
+            && getStdClassName(callee->getParamDecl(0)->getType().getNonReferenceType()->getAsCXXRecordDecl()) == "variant";
+
+        const bool throws = llvm::StringSwitch<bool>(callee->getName())
+            .Cases("stoi", "stol", "stoll", "stoul", "stoull", true)
+            .Cases("stof", "stod", "stold", true)
+            .Case("any_cast", callee->getNumParams() == 1 && !callee->getParamDecl(0)->getType()->isPointerType())
+            .Case("get", is_variant_get)
+            .Default(false);
+
+        if (throws) {
+            return "std::" + callee->getName().str();
+        }
+        return std::nullopt;
+    }
+
+    // functions with bodies are followed, C functions don't throw
+    if (callee->hasBody() || callee->isExternC()) {
+        return std::nullopt;
+    }
+    return callee->getQualifiedNameAsString();
+}
+
+} // namespace anonymous
+
+bool reachesCaller(const CallSite & site, const Effect effect)
+{
+    if (site.in_lambda) {
+        return false;
+    }
+    if (effect == Effect::Throw) {
+        return !site.in_try && !(site.callee && isNoexcept(site.callee));
+    }
+    return true;
+}
+
+std::optional<std::string> getDirectEffect(const CallSite & site, const Effect effect)
+{
+    switch (effect) {
+    case Effect::Allocation:
+        return getAllocation(site);
+    case Effect::Blocking:
+        return getBlocking(site);
+    case Effect::Throw:
+        return getThrow(site);
+    }
+
+    __builtin_unreachable(); // just to silence -Wreturn-type warning
+}
+
+} // namespace ica
@@ -0,0 +1,61 @@
+#include "shared/common/FileFilter.h"
+
+#include "llvm/Support/Error.h"
+
+#include <algorithm>
+
+namespace ica {
+
+namespace {
+
+std::optional<std::string> parseGlobs(const std::string_view globs, std::vector<llvm::GlobPattern> & patterns)
+{
+    auto rest = llvm::StringRef(globs.data(), globs.size());
+
+    while (!rest.empty()) {
+        llvm::StringRef glob;
+        std::tie(glob, rest) = rest.split(',');
+
+        if (glob.empty()) {
+            continue;
+        }
+
+        auto pattern = llvm::GlobPattern::create(glob);
+        if (!pattern) {
+            return "Can't parse glob '" + glob.str() + "': " + llvm::toString(pattern.takeError());
+        }
+        patterns.push_back(std::move(*pattern));
+    }
+
+    return std::nullopt;
+}
+
+bool matchesAny(const std::vector<llvm::GlobPattern> & patterns, const llvm::ArrayRef<llvm::StringRef> paths)
+{
+    return std::any_of(patterns.begin(), patterns.end(), [paths] (const auto & pattern) {
+        return std::any_of(paths.begin(), paths.end(),
+                [&pattern] (const auto path) { return !path.empty() && pattern.match(path); });
+    });
+}
+
+} // namespace anonymous
+
+std::optional<std::string> FileFilter::parseInclude(const std::string_view globs)
+{
+    return parseGlobs(globs, m_include);
+}
+
+std::optional<std::string> FileFilter::parseExclude(const std::string_view globs)
+{
+    return parseGlobs(globs, m_exclude);
+}
+
+bool FileFilter::accepts(const llvm::ArrayRef<llvm::StringRef> paths) const
+{
+    if (!m_include.empty() && !matchesAny(m_include, paths)) {
+        return false;
+    }
+    return !matchesAny(m_exclude, paths);
+}
+
+} // namespace ica
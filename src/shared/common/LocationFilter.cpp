@@ -0,0 +1,62 @@
+#include "shared/common/LocationFilter.h"
+
+#include "clang/Basic/FileManager.h"
+
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/Path.h"
+
+namespace ica {
+
+bool LocationFilter::shouldVisit(const clang::Decl * decl)
+{
+    const auto loc = m_source_manager.getExpansionLoc(decl->getLocation());
+    if (loc.isInvalid()) {
+        return true;
+    }
+
+    const auto file_id = m_source_manager.getFileID(loc);
+    const auto [it, inserted] = m_should_visit_file.try_emplace(file_id, true);
+    if (inserted) {
+        it->second = computeShouldVisit(file_id);
+    }
+    return it->second;
+}
+
+bool LocationFilter::computeShouldVisit(const clang::FileID file_id) const
+{
+    const auto * file_entry = m_source_manager.getFileEntryForID(file_id);
+    if (!file_entry) {
+        return true; // built-ins, command line macros, etc.
+    }
+
+    if (m_main_file_only && !isMainFileOrItsHeader(file_id, *file_entry)) {
+        return false;
+    }
+
+    // globs are matched against both the path as written in the compile command/include directive
+    // and the real absolute path, so both relative and absolute patterns work
+    return m_file_filter.accepts({file_entry->getName(), file_entry->tryGetRealPathName()});
+}
+
+bool LocationFilter::isMainFileOrItsHeader(const clang::FileID file_id, const clang::FileEntry & file_entry) const
+{
+    const auto main_file_id = m_source_manager.getMainFileID();
+    if (file_id == main_file_id) {
+        return true;
+    }
+
+    const auto * main_file_entry = m_source_manager.getFileEntryForID(main_file_id);
+    if (!main_file_entry) {
+        return false;
+    }
+
+    // 'foo.cpp' is paired with 'foo.h' (from any directory, e.g. 'src/foo.cpp' and 'include/foo.h')
+    const auto name = file_entry.getName();
+    const bool is_header = llvm::StringSwitch<bool>(llvm::sys::path::extension(name))
+        .Cases(".h", ".hh", ".hpp", ".hxx", ".h++", true)
+        .Default(false);
+
+    return is_header && llvm::sys::path::stem(name) == llvm::sys::path::stem(main_file_entry->getName());
+}
+
+} // namespace ica
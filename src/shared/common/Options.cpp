@@ -0,0 +1,99 @@
+#include "shared/common/Options.h"
+
+#include <algorithm>
+
+namespace ica {
+
+namespace {
+
+std::string_view describeType(const OptionDeclaration::Type type)
+{
+    switch (type) {
+    case OptionDeclaration::Bool    : return "'true' or 'false'";
+    case OptionDeclaration::Unsigned: return "a non-negative integer";
+    case OptionDeclaration::String  : return "a string";
+    }
+
+    __builtin_unreachable(); // just to silence -Wreturn-type warning
+}
+
+} // namespace anonymous
+
+std::optional<std::string> Options::parse(const std::string_view options_list)
+{
+    auto rest = llvm::StringRef(options_list.data(), options_list.size());
+
+    while (!rest.empty()) {
+        llvm::StringRef curr;
+        std::tie(curr, rest) = rest.split(',');
+
+        if (curr.empty()) {
+            continue;
+        }
+
+        const auto [key, value] = curr.split('=');
+        const auto [check, option] = key.split('.');
+        if (check.empty() || option.empty() || value.empty() || key.size() == curr.size()) {
+            return "Can't parse option '" + curr.str() + "': expected 'check-name.option-name=value'";
+        }
+
+        m_options[key.str()] = value.str();
+    }
+
+    return std::nullopt;
+}
+
+void Options::merge(const Options & overrides)
+{
+    for (const auto & [key, value] : overrides.m_options) {
+        m_options[key] = value;
+    }
+}
+
+std::optional<std::string> Options::resolve(const llvm::ArrayRef<OptionDeclaration> declarations)
+{
+    m_values.clear();
+
+    for (const auto & [key, value] : m_options) {
+        const auto [check, option] = llvm::StringRef(key).split('.');
+        const auto declaration = std::find_if(declarations.begin(), declarations.end(),
+                [check = check, option = option] (const OptionDeclaration & declaration) {
+                    return check == llvm::StringRef(declaration.check.data(), declaration.check.size())
+                        && option == llvm::StringRef(declaration.option.data(), declaration.option.size());
+                });
+        if (declaration == declarations.end()) {
+            return "Unknown option '" + key + "'";
+        }
+
+        auto converted = convert(value, declaration->type);
+        if (!converted) {
+            return "Can't parse option '" + key + "=" + value + "': expected " + std::string(describeType(declaration->type));
+        }
+        m_values.emplace(key, std::move(*converted));
+    }
+
+    return std::nullopt;
+}
+
+std::optional<Options::Value> Options::convert(const llvm::StringRef value, const OptionDeclaration::Type type)
+{
+    switch (type) {
+    case OptionDeclaration::Bool:
+        if (value == "true" || value == "1") return Value(true);
+        if (value == "false" || value == "0") return Value(false);
+        return std::nullopt;
+    case OptionDeclaration::Unsigned: {
+        std::uint64_t result = 0;
+        if (value.getAsInteger(0, result)) {
+            return std::nullopt;
+        }
+        return Value(result);
+    }
+    case OptionDeclaration::String:
+        return Value(value.str());
+    }
+
+    __builtin_unreachable(); // just to silence -Wreturn-type warning
+}
+
+} // namespace ica
@@ -0,0 +1,257 @@
+#include "shared/common/Profile.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Demangle/Demangle.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <cctype>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ica {
+
+namespace {
+
+constexpr llvm::StringLiteral anonymous_namespace = "(anonymous namespace)";
+
+bool isIdentifierChar(const char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/// Appends 'operator' with its operator token, e.g. 'operator()', 'operator<<', 'operator bool',
+/// returns the position after it
+std::size_t appendOperator(const llvm::StringRef symbol, std::size_t pos, std::string & result)
+{
+    const llvm::StringRef keyword = "operator";
+    result += keyword;
+    pos += keyword.size();
+
+    if (symbol.substr(pos).startswith("()") || symbol.substr(pos).startswith("[]")) {
+        result += symbol.substr(pos, 2);
+        return pos + 2;
+    }
+
+    const llvm::StringRef operator_chars = "+-*/%^&|~!=<>,";
+    if (pos < symbol.size() && operator_chars.contains(symbol[pos])) {
+        while (pos < symbol.size() && operator_chars.contains(symbol[pos])) {
+            result += symbol[pos++];
+        }
+        return pos;
+    }
+
+    // conversion operators, 'operator new', 'operator delete'
+    while (pos < symbol.size() && symbol[pos] != '(' && symbol[pos] != '<') {
+        result += symbol[pos++];
+    }
+    return pos;
+}
+
+/// Skips the balanced group started at 'pos' by 'open', returns the position after it
+std::size_t skipGroup(const llvm::StringRef symbol, std::size_t pos, const char open, const char close)
+{
+    unsigned depth = 0;
+    for (; pos < symbol.size(); ++pos) {
+        if (symbol[pos] == open) {
+            ++depth;
+        } else if (symbol[pos] == close && --depth == 0) {
+            return pos + 1;
+        }
+    }
+    return pos;
+}
+
+/// Skips cv- and ref-qualifiers following a parameter list, returns the position after them
+std::size_t skipQualifiers(const llvm::StringRef symbol, std::size_t pos)
+{
+    while (pos < symbol.size()) {
+        const auto rest = symbol.substr(pos);
+        if (rest.startswith(" ") || rest.startswith("&")) {
+            ++pos;
+            continue;
+        }
+
+        bool skipped = false;
+        for (const llvm::StringRef qualifier : {"const", "volatile"}) {
+            if (rest.startswith(qualifier) && (rest.size() == qualifier.size() || !isIdentifierChar(rest[qualifier.size()]))) {
+                pos += qualifier.size();
+                skipped = true;
+            }
+        }
+        if (!skipped) {
+            break;
+        }
+    }
+    return pos;
+}
+
+class ProfileFileCache
+{
+public:
+    const ProfileFile & get(const llvm::StringRef path)
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (const auto it = m_files.find(path.str()); it != m_files.end()) {
+            return *it->second;
+        }
+
+        auto file = std::make_unique<ProfileFile>();
+        file->error = file->profile.load(path);
+        return *m_files.emplace(path.str(), std::move(file)).first->second;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<ProfileFile>> m_files;
+};
+
+} // namespace anonymous
+
+const ProfileFile & getProfileFile(const llvm::StringRef path)
+{
+    static ProfileFileCache cache;
+    return cache.get(path);
+}
+
+std::optional<std::string> Profile::load(const llvm::StringRef path)
+{
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer) {
+        return "Can't read profile '" + path.str() + "': " + buffer.getError().message();
+    }
+
+    if (auto error = parse((*buffer)->getBuffer()); error) {
+        return "Can't parse profile '" + path.str() + "': " + *error;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> Profile::parse(const llvm::StringRef content)
+{
+    llvm::SmallVector<llvm::StringRef, 32> lines;
+    content.split(lines, '\n', /*MaxSplit=*/ -1, /*KeepEmpty=*/ false);
+
+    for (auto line : lines) {
+        line = line.trim();
+        if (line.empty() || line.startswith("#")) {
+            continue;
+        }
+
+        const auto [location, samples_str] = line.rsplit(' ');
+        std::uint64_t samples = 0;
+        if (location.empty() || samples_str.getAsInteger(10, samples)) {
+            return "expected '<stack or path:line> <samples>', got '" + line.str() + "'";
+        }
+
+        // 'path:line' or 'path:first-last', the line part has no other characters
+        const auto [path, lines_str] = location.rsplit(':');
+        if (!path.empty() && !path.endswith(":") && !lines_str.empty()
+                && lines_str.find_first_not_of("0123456789-") == llvm::StringRef::npos) {
+            const auto [first_str, last_str] = lines_str.split('-');
+            LineSamples line_samples{path.str(), 0, 0, samples};
+            if (first_str.getAsInteger(10, line_samples.first_line)) {
+                return "can't parse line number in '" + line.str() + "'";
+            }
+            line_samples.last_line = line_samples.first_line;
+            if (!last_str.empty() && last_str.getAsInteger(10, line_samples.last_line)) {
+                return "can't parse line number in '" + line.str() + "'";
+            }
+            m_lines.push_back(std::move(line_samples));
+            m_total_line_samples += samples;
+            continue;
+        }
+
+        m_total_stack_samples += samples;
+
+        // every function of the stack is accounted once, even if it's recursive
+        llvm::StringSet<> stack_symbols;
+        llvm::SmallVector<llvm::StringRef, 32> frames;
+        location.split(frames, ';', /*MaxSplit=*/ -1, /*KeepEmpty=*/ false);
+        for (const auto frame : frames) {
+            const auto symbol = normalizeSymbol(frame);
+            if (symbol.empty() || !stack_symbols.insert(symbol).second) {
+                continue;
+            }
+            m_symbols[symbol] += samples;
+
+            const auto [qualifier, name] = llvm::StringRef(symbol).rsplit("::");
+            m_unqualified_names.try_emplace(name.empty() ? qualifier : name);
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::uint64_t Profile::getSymbolSamples(const llvm::StringRef qualified_name) const
+{
+    const auto it = m_symbols.find(qualified_name);
+    return it != m_symbols.end() ? it->second : 0;
+}
+
+std::string Profile::normalizeSymbol(llvm::StringRef symbol)
+{
+    symbol = symbol.trim();
+
+    // 'libfoo.so`symbol'
+    if (const auto pos = symbol.find('`'); pos != llvm::StringRef::npos) {
+        symbol = symbol.substr(pos + 1);
+    }
+    // 'symbol+0x1f'
+    if (const auto pos = symbol.rfind("+0x"); pos != llvm::StringRef::npos) {
+        symbol = symbol.substr(0, pos);
+    }
+    // perf annotations: 'symbol_[k]', 'symbol_[j]'
+    if (symbol.size() > 4 && symbol.endswith("]") && symbol.substr(symbol.size() - 4).startswith("_[")) {
+        symbol = symbol.drop_back(4);
+    }
+    // '[unknown]', '[libc.so.6]'
+    if (symbol.startswith("[")) {
+        return {};
+    }
+
+    std::string demangled = symbol.startswith("_Z") ? llvm::demangle(symbol.str()) : symbol.str();
+    symbol = demangled;
+
+    // ' [clone .isra.0]' (binutils), ' (.cold)' (LLVM demangler)
+    for (const llvm::StringRef suffix : {" [clone", " (."}) {
+        if (const auto pos = symbol.find(suffix); pos != llvm::StringRef::npos) {
+            symbol = symbol.substr(0, pos);
+        }
+    }
+
+    std::string result;
+    result.reserve(symbol.size());
+    for (std::size_t pos = 0; pos < symbol.size();) {
+        const bool word_start = pos == 0 || !isIdentifierChar(symbol[pos - 1]);
+        if (word_start && symbol.substr(pos).startswith("operator")
+                && (pos + 8 == symbol.size() || !isIdentifierChar(symbol[pos + 8]))) {
+            pos = appendOperator(symbol, pos, result);
+        } else if (symbol.substr(pos).startswith(anonymous_namespace)) {
+            result += anonymous_namespace;
+            pos += anonymous_namespace.size();
+        } else if (symbol[pos] == '(') {
+            pos = skipQualifiers(symbol, skipGroup(symbol, pos, '(', ')'));
+        } else if (symbol[pos] == '<') {
+            pos = skipGroup(symbol, pos, '<', '>');
+        } else {
+            result += symbol[pos++];
+        }
+    }
+
+    auto name = llvm::StringRef(result).trim();
+
+    // return type of demangled function templates: 'int ns::f<int>(int)'
+    if (name.find("operator ") == llvm::StringRef::npos) {
+        const auto anonymous_pos = name.find(anonymous_namespace);
+        if (const auto pos = name.substr(0, anonymous_pos).rfind(' '); pos != llvm::StringRef::npos) {
+            name = name.substr(pos + 1);
+        }
+    }
+
+    return name.str();
+}
+
+} // namespace ica
@@ -0,0 +1,255 @@
+#include "shared/common/ProfileFilter.h"
+#include "shared/common/Common.h"
+
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/Basic/FileManager.h"
+
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Path.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string>
+
+namespace ica {
+
+namespace {
+
+constexpr unsigned default_hot_percent = 1;
+constexpr unsigned default_cold_percent = 0;
+
+/// Whether the paths are the same file, compared by trailing components: a profile
+/// usually has paths of the build machine, a compilation - relative or absolute ones of its own
+bool isSameFile(const llvm::StringRef file_path, const llvm::StringRef profile_path)
+{
+    auto file_it = llvm::sys::path::rbegin(file_path);
+    auto profile_it = llvm::sys::path::rbegin(profile_path);
+    const auto file_end = llvm::sys::path::rend(file_path);
+    const auto profile_end = llvm::sys::path::rend(profile_path);
+
+    bool matched = false;
+    for (; file_it != file_end && profile_it != profile_end; ++file_it, ++profile_it) {
+        if (*file_it == ".." || *profile_it == ".." || *file_it == "." || *profile_it == ".") {
+            break;
+        }
+        if (*file_it != *profile_it) {
+            return false;
+        }
+        matched = true;
+    }
+    return matched;
+}
+
+double percentOf(const std::uint64_t samples, const std::uint64_t total_samples)
+{
+    return total_samples == 0 ? 0. : 100. * samples / total_samples;
+}
+
+/// Number of arguments of a diagnostic format string: one more than the greatest index of
+/// '%0', '%s1', '%select{...}2' and alike, '%%' is an escaped percent sign
+unsigned getArgumentCount(const llvm::StringRef format_string)
+{
+    unsigned count = 0;
+    for (auto pos = format_string.find('%'); pos != llvm::StringRef::npos; pos = format_string.find('%', pos + 1)) {
+        auto end = pos + 1;
+        if (end < format_string.size() && format_string[end] == '%') {
+            pos = end;
+            continue;
+        }
+
+        while (end < format_string.size() && std::isalpha(static_cast<unsigned char>(format_string[end]))) {
+            ++end;
+        }
+        // options of the modifier may refer to arguments of their own, they are found by the outer loop
+        if (end < format_string.size() && format_string[end] == '{') {
+            for (unsigned depth = 0; end < format_string.size(); ++end) {
+                if (format_string[end] == '{') {
+                    ++depth;
+                } else if (format_string[end] == '}' && --depth == 0) {
+                    ++end;
+                    break;
+                }
+            }
+        }
+        if (end < format_string.size() && std::isdigit(static_cast<unsigned char>(format_string[end]))) {
+            count = std::max(count, static_cast<unsigned>(format_string[end] - '0') + 1);
+        }
+    }
+    return count;
+}
+
+} // namespace anonymous
+
+ProfileFilter::ProfileFilter(const Config & config, const clang::SourceManager & source_manager)
+    : m_profile(*config.get_profile())
+    , m_source_manager(source_manager)
+    , m_hot_percent(config.get_options().get<unsigned>("profile", "hot-percent").value_or(default_hot_percent))
+    , m_cold_percent(config.get_options().get<unsigned>("profile", "cold-percent").value_or(default_cold_percent))
+    , m_raise_hot(config.get_options().get<bool>("profile", "raise-hot").value_or(false))
+{
+}
+
+void ProfileFilter::addFunctions(const clang::Decl * decl)
+{
+    if (!decl || decl->isFromASTFile() || decl->isImplicit() || isExpansionInSystemHeader(decl, m_source_manager)) {
+        return;
+    }
+
+    // templates are recorded once, by the pattern: instantiations share its source range
+    if (const auto * function_template = clang::dyn_cast<clang::FunctionTemplateDecl>(decl)) {
+        decl = function_template->getTemplatedDecl();
+    } else if (const auto * class_template = clang::dyn_cast<clang::ClassTemplateDecl>(decl)) {
+        decl = class_template->getTemplatedDecl();
+    }
+
+    if (const auto * function = clang::dyn_cast<clang::FunctionDecl>(decl)) {
+        if (function->doesThisDeclarationHaveABody()) {
+            addFunction(function);
+        }
+        return;
+    }
+
+    if (clang::isa<clang::NamespaceDecl>(decl) || clang::isa<clang::LinkageSpecDecl>(decl) || clang::isa<clang::CXXRecordDecl>(decl)) {
+        for (const auto * child : clang::cast<clang::DeclContext>(decl)->decls()) {
+            addFunctions(child);
+        }
+    }
+}
+
+void ProfileFilter::addFunction(const clang::FunctionDecl * decl)
+{
+    const auto range = decl->getSourceRange();
+    const auto [file_id, begin] = m_source_manager.getDecomposedLoc(m_source_manager.getExpansionLoc(range.getBegin()));
+    const auto [end_file_id, end] = m_source_manager.getDecomposedLoc(m_source_manager.getExpansionLoc(range.getEnd()));
+    if (file_id.isInvalid() || file_id != end_file_id) {
+        return;
+    }
+
+    const auto stack_samples = getSymbolSamples(decl);
+    const auto line_samples = getLineSamples(file_id,
+            m_source_manager.getLineNumber(file_id, begin),
+            m_source_manager.getLineNumber(file_id, end));
+
+    auto & functions = m_functions[file_id];
+    functions.sorted = functions.sorted && (functions.ranges.empty() || functions.ranges.back().begin < begin);
+    functions.ranges.push_back({begin, end, stack_samples, line_samples});
+}
+
+std::uint64_t ProfileFilter::getSymbolSamples(const clang::FunctionDecl * decl) const
+{
+    // qualified name is built only for functions having a namesake in the profile
+    const auto name = decl->getDeclName();
+    if (name.isIdentifier() ? !m_profile.hasUnqualifiedName(decl->getName())
+                            : !m_profile.hasUnqualifiedName(name.getAsString())) {
+        return 0;
+    }
+    return m_profile.getSymbolSamples(Profile::normalizeSymbol(decl->getQualifiedNameAsString()));
+}
+
+std::uint64_t ProfileFilter::getLineSamples(const clang::FileID file_id, const unsigned first_line, const unsigned last_line)
+{
+    std::uint64_t samples = 0;
+    for (const auto * line_samples : getFileLineSamples(file_id)) {
+        if (line_samples->first_line <= last_line && first_line <= line_samples->last_line) {
+            samples += line_samples->samples;
+        }
+    }
+    return samples;
+}
+
+const std::vector<const Profile::LineSamples *> & ProfileFilter::getFileLineSamples(const clang::FileID file_id)
+{
+    const auto [it, inserted] = m_file_lines.try_emplace(file_id);
+    if (!inserted || m_profile.getLineSamples().empty()) {
+        return it->second;
+    }
+
+    if (const auto * file_entry = m_source_manager.getFileEntryForID(file_id)) {
+        for (const auto & line_samples : m_profile.getLineSamples()) {
+            if (isSameFile(file_entry->getName(), line_samples.path)
+                    || isSameFile(file_entry->tryGetRealPathName(), line_samples.path)) {
+                it->second.push_back(&line_samples);
+            }
+        }
+    }
+    return it->second;
+}
+
+std::optional<ProfileFilter::Weight> ProfileFilter::getWeight(const clang::SourceLocation loc)
+{
+    if (loc.isInvalid()) {
+        return std::nullopt;
+    }
+
+    const auto [file_id, offset] = m_source_manager.getDecomposedLoc(m_source_manager.getExpansionLoc(loc));
+    const auto it = m_functions.find(file_id);
+    if (it == m_functions.end()) {
+        return std::nullopt;
+    }
+
+    // function bodies aren't walked, so the recorded ranges don't overlap
+    auto & functions = it->second;
+    if (!functions.sorted) {
+        std::sort(functions.ranges.begin(), functions.ranges.end(),
+                [] (const auto & l, const auto & r) { return l.begin < r.begin; });
+        functions.sorted = true;
+    }
+
+    const auto next = std::upper_bound(functions.ranges.begin(), functions.ranges.end(), offset,
+            [] (const unsigned offset, const auto & range) { return offset < range.begin; });
+    if (next == functions.ranges.begin() || std::prev(next)->end < offset) {
+        return std::nullopt;
+    }
+
+    // stacks and source ranges may be views of the same run, so their samples aren't added up:
+    // the function is weighed by the view, in which it has a larger share
+    const auto & range = *std::prev(next);
+    const auto stack_percent = percentOf(range.stack_samples, m_profile.getTotalStackSamples());
+    const auto line_percent = percentOf(range.line_samples, m_profile.getTotalLineSamples());
+
+    Weight weight;
+    weight.samples = stack_percent >= line_percent ? range.stack_samples : range.line_samples;
+    weight.percent = std::max(stack_percent, line_percent);
+    if (weight.samples == 0 || weight.percent < m_cold_percent) {
+        weight.hotness = Hotness::Cold;
+    } else if (weight.percent >= m_hot_percent) {
+        weight.hotness = Hotness::Hot;
+    }
+    return weight;
+}
+
+clang::DiagnosticIDs::Level ProfileFilter::raiseLevel(const clang::DiagnosticIDs::Level level)
+{
+    switch (level) {
+    case clang::DiagnosticIDs::Note:
+    case clang::DiagnosticIDs::Remark:
+        return clang::DiagnosticIDs::Warning;
+    case clang::DiagnosticIDs::Warning:
+        return clang::DiagnosticIDs::Error;
+    default:
+        return level;
+    }
+}
+
+std::string ProfileFilter::formatWeight(const Weight & weight)
+{
+    return llvm::formatv(" [{0}{1} samples, {2:F1}% of the profile]",
+            weight.hotness == Hotness::Hot ? "hot: " : "",
+            weight.samples,
+            weight.percent).str();
+}
+
+DiagnosticID ProfileFilter::getWeightedDiagID(clang::DiagnosticIDs & diagnostic_ids, const DiagnosticID diag_id,
+                                              const clang::DiagnosticIDs::Level level)
+{
+    const auto [it, inserted] = m_weighted_diag_ids.try_emplace({diag_id, static_cast<unsigned>(level)});
+    if (inserted) {
+        const auto format_string = diagnostic_ids.getDescription(diag_id);
+        it->second = diagnostic_ids.getCustomDiagID(level, format_string.str() + '%' + std::to_string(getArgumentCount(format_string)));
+    }
+    return it->second;
+}
+
+} // namespace ica
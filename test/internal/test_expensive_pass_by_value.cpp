@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct Small
+{
+    int a = 0;
+    int b = 0;
+};
+
+struct Large
+{
+    long values[4] = {};
+};
+
+struct MoveOnly
+{
+    MoveOnly() = default;
+    MoveOnly(MoveOnly &&) = default;
+    std::unique_ptr<int> value;
+};
+
+struct Holder
+{
+    std::unique_ptr<int> value;
+};
+
+bool has_spaces(std::string text) // expected-warning {{'text' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return text.find(' ') != std::string::npos;
+}
+
+std::size_t total(const std::vector<int> values) // expected-warning {{'values' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return values.size();
+}
+
+long sum(Large large, Small small, std::string_view view) // expected-warning {{'large' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return large.values[0] + small.a + static_cast<long>(view.size());
+}
+
+bool is_set(std::shared_ptr<int> ptr) // expected-warning {{'ptr' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return ptr.get() != nullptr;
+}
+
+std::string modified(std::string text)
+{
+    text += "!";
+    return text;
+}
+
+std::string returned(std::string text)
+{
+    return text;
+}
+
+struct Sink
+{
+    explicit Sink(std::string name)
+        : m_name(std::move(name))
+    { }
+
+    void set(std::vector<int> values)
+    {
+        m_values.swap(values);
+    }
+
+    std::string m_name;
+    std::vector<int> m_values;
+};
+
+void sorted(std::vector<int> values) // may be modified by a template function
+{
+    std::sort(values.begin(), values.end());
+}
+
+int move_only(MoveOnly value, Holder holder)
+{
+    return *value.value + *holder.value;
+}
+
+std::size_t declared_twice(std::string text);
+
+std::size_t declared_twice(std::string text) // expected-warning {{'text' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return text.size();
+}
+
+struct Base
+{
+    virtual std::size_t size(std::string text) const
+    {
+        return text.size();
+    }
+};
+
+bool is_empty(std::string text) // expected-warning {{'text' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return text.empty();
+}
+
+bool is_long(std::string text) // expected-warning {{'text' is expensive to copy, but it's only read, consider passing it by 'const' reference}}
+{
+    return text.size() > 80;
+}
+
+// the calls don't prevent the fix-it of 'has_spaces', the stored addresses do prevent the ones of 'is_empty' and 'is_long'
+bool (* const empty_callback)(std::string) = &is_empty;
+bool (* const callbacks[])(std::string) = { is_long };
+
+bool check_all(const std::string & text)
+{
+    return has_spaces(text) && sum(Large{}, Small{}, text) != 0;
+}
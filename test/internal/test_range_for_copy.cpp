@@ -0,0 +1,95 @@
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct Small
+{
+    int a = 0;
+    int b = 0;
+};
+
+struct Large
+{
+    long values[4] = {};
+};
+
+std::size_t read_strings(const std::vector<std::string> & names)
+{
+    std::size_t result = 0;
+    for (auto name : names) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += name.size();
+    }
+    for (const std::string name : names) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += name.size();
+    }
+    for (const auto & name : names) {
+        result += name.size();
+    }
+    return result;
+}
+
+long read_structs(const std::vector<Large> & large, const std::vector<Small> & small)
+{
+    long result = 0;
+    for (auto l : large) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += l.values[0];
+    }
+    for (auto s : small) { // expected-warning {{'const' should be specified explicitly for variable in for-range loop}}
+        result += s.a;
+    }
+    return result;
+}
+
+std::size_t read_map(const std::map<std::string, int> & map)
+{
+    std::size_t result = 0;
+    for (auto [key, value] : map) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += key.size() + value;
+    }
+    return result;
+}
+
+std::vector<std::string> modified(const std::vector<std::string> & names)
+{
+    std::vector<std::string> result;
+    for (auto name : names) {
+        name += "!";
+        result.push_back(name);
+    }
+    for (auto name : names) {
+        result.push_back(std::move(name));
+    }
+    return result;
+}
+
+std::size_t converted(const std::vector<const char *> & names)
+{
+    std::size_t result = 0;
+    for (std::string name : names) { // expected-warning {{'const' should be specified explicitly for variable in for-range loop}}
+        result += name.size();
+    }
+    return result;
+}
+
+long shared(const std::vector<std::shared_ptr<long>> & pointers)
+{
+    long result = 0;
+    for (auto pointer : pointers) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += *pointer;
+    }
+    return result;
+}
+
+std::size_t spelled_types(const std::vector<std::string> & names)
+{
+    std::size_t result = 0;
+    for (const auto name : names) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += name.size();
+    }
+    for (std::string name : names) { // expected-warning {{loop variable copies every element of the range, consider binding it by 'const' reference}}
+        result += name.size();
+    }
+    return result;
+}
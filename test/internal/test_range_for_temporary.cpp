@@ -0,0 +1,75 @@
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct Name
+{
+    Name(const std::string & value)
+        : value(value)
+    { }
+
+    std::string value;
+};
+
+struct Wrapper
+{
+    operator Name() const
+    { return Name(text); }
+
+    std::string text;
+};
+
+std::size_t map_pairs(const std::map<std::string, int> & map, const std::unordered_map<int, std::string> & hash_map)
+{
+    std::size_t result = 0;
+    for (const std::pair<std::string, int> & p : map) { // expected-warning-re {{loop variable copies every element: 'std::pair<std::{{.*}}, int>' differs from the element type 'std::pair<const std::{{.*}}, int>' in qualifiers only, consider 'const auto &'}}
+        result += p.second;
+    }
+    for (std::pair<int, std::string> && p : hash_map) { // expected-warning-re {{loop variable copies every element: 'std::pair<int, std::{{.*}}>' differs from the element type 'std::pair<const int, std::{{.*}}>' in qualifiers only, consider 'const auto &'}}
+        result += p.first;
+    }
+    for (const std::pair<const std::string, int> & p : map) {
+        result += p.second;
+    }
+    for (const auto & p : map) {
+        result += p.second;
+    }
+    return result;
+}
+
+std::size_t conversions(const std::vector<std::string> & strings, const std::vector<Wrapper> & wrappers, const std::vector<int> & ints,
+                        const std::vector<std::pair<int, int>> & pairs)
+{
+    std::size_t result = 0;
+    for (const Name & name : strings) { // expected-warning-re {{loop variable is bound to a temporary 'Name' converted from 'std::{{.*}}' on every iteration}}
+        result += name.value.size();
+    }
+    for (const Name & name : wrappers) { // expected-warning {{loop variable is bound to a temporary 'Name' converted from 'Wrapper' on every iteration}}
+        result += name.value.size();
+    }
+    for (const std::string_view view : strings) { // not a reference
+        result += view.size();
+    }
+    for (const std::string_view & view : strings) { // a cheap conversion is intended
+        result += view.size();
+    }
+    for (const std::pair<long, int> & pair : pairs) { // another template argument, not a copy of the element
+        result += pair.second;
+    }
+    for (const long & value : ints) { // not a class
+        result += value;
+    }
+    return result;
+}
+
+std::size_t by_value(const std::vector<bool> & bits)
+{
+    std::size_t result = 0;
+    for (const auto & bit : bits) { // the element is returned by value, not converted
+        result += bit;
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+#!/bin/bash
+#
+# Time budget test: a large translation unit wrapped into a namespace, which is a single top level
+# declaration, exceeds 'budget-ms=1'. The check must be skipped in the middle of the namespace
+# and named by the remark, so it doesn't report all the functions.
+#
+# Usage: do_budget.sh <clang++> <libica-plugin.so> [compiler args...]
+
+set -u
+
+COMPILER=$1
+PLUGIN=$2
+shift 2
+
+FUNCTIONS=20000
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+SOURCE="${WORK_DIR}/test_budget.cpp"
+
+{
+    echo "int isalpha(int);"
+    echo "namespace budget {"
+    for ((i = 0; i < FUNCTIONS; ++i)); do
+        echo "int f${i}(char c) { return isalpha(c); }"
+    done
+    echo "} // namespace budget"
+} > "${SOURCE}"
+
+OUTPUT=$("${COMPILER}" --std=c++17 "$@" -Xclang -load -Xclang "${PLUGIN}" -Xclang -add-plugin -Xclang ica-plugin \
+    -Xclang -plugin-arg-ica-plugin -Xclang checks=char-in-ctype-pred \
+    -Xclang -plugin-arg-ica-plugin -Xclang no-url \
+    -Xclang -plugin-arg-ica-plugin -Xclang budget-ms=1 \
+    -fsyntax-only "${SOURCE}" 2>&1)
+
+if ! grep -q "remark: ICA time budget of 1 ms is exceeded, skipped checks for the rest of the file: char-in-ctype-pred" <<< "${OUTPUT}"; then
+    echo "No remark about the exceeded time budget:"
+    tail -n 20 <<< "${OUTPUT}"
+    exit 1
+fi
+
+WARNINGS=$(grep -c "warning: .*\[char-in-ctype-pred\]" <<< "${OUTPUT}")
+if ((WARNINGS >= FUNCTIONS)); then
+    echo "The check isn't skipped before the end of the namespace: ${WARNINGS} warnings of ${FUNCTIONS} functions"
+    exit 1
+fi
@@ -0,0 +1,11 @@
+int isalpha(int);
+
+struct Test
+{
+    inline int foo(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
+
+int main()
+{
+    return isalpha('x'); // expected-error {{'isalpha' called with 'char' argument which may be UB. Use static_cast to unsigned char}}
+}
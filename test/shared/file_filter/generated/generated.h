@@ -0,0 +1,16 @@
+// Matches 'exclude=*/generated/*', nothing is reported here
+
+#include <mutex>
+
+struct Generated
+{
+    inline int bar();
+};
+
+inline int Generated::bar()
+{
+    std::mutex m;
+    std::unique_lock<std::mutex> g(m);
+    g.release();
+    return 42;
+}
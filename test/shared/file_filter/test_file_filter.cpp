@@ -0,0 +1,14 @@
+#include "generated/generated.h"
+
+struct NotGenerated
+{
+    inline int bar(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
+
+inline int NotGenerated::bar()
+{
+    std::mutex m;
+    std::unique_lock<std::mutex> g(m);
+    g.release(); // expected-warning {{std::unique_lock 'release()' method result unused, mutex is locked}}
+    return Generated().bar();
+}
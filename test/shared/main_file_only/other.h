@@ -0,0 +1,11 @@
+// Not paired with test_main_file_only.cpp, nothing is reported here
+
+struct Other
+{
+    inline int bar();
+};
+
+inline int Other::bar()
+{
+    return 42;
+}
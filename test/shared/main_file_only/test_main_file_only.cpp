@@ -0,0 +1,12 @@
+#include "other.h"
+#include "test_main_file_only.h"
+
+struct Main
+{
+    inline int bar(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
+
+inline int Main::bar()
+{
+    return Paired().bar() + Other().bar();
+}
@@ -0,0 +1,11 @@
+// Paired with test_main_file_only.cpp, so it's analyzed
+
+struct Paired
+{
+    inline int bar(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
+
+inline int Paired::bar()
+{
+    return 42;
+}
@@ -0,0 +1,23 @@
+struct Local
+{
+    inline int bar(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
+
+inline int Local::bar()
+{
+    return FromPrecompiledHeader().bar();
+}
+
+struct Handler
+{
+    void handle()
+    {
+        delete new int(0); // expected-warning {{'operator new' may allocate memory on the hot path of 'dispatch<Handler>'}}
+                           // expected-note@test_pch.h:18 {{'Handler::handle' is called here}}
+    }
+};
+
+void run(Handler & handler)
+{
+    dispatch(handler);
+}
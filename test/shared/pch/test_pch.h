@@ -0,0 +1,19 @@
+// Compiled into a precompiled header: its declarations are neither traversed nor deserialized
+// by the plugin, so there is no warning for them in the translation unit using the header
+
+struct FromPrecompiledHeader
+{
+    inline int bar();
+};
+
+inline int FromPrecompiledHeader::bar()
+{
+    return 42;
+}
+
+// Instantiations are made by the translation unit, so they are checked there
+template <class Handler>
+[[clang::annotate("ica::hot")]] void dispatch(Handler & handler)
+{
+    handler.handle();
+}
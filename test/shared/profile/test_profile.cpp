@@ -0,0 +1,45 @@
+#include <cctype>
+#include <string>
+#include <string_view>
+
+struct Sink
+{
+    void consume(std::string_view s);
+};
+
+namespace orders {
+
+// 90% of the samples: severity is raised
+void match(Sink & sink, const std::string & s)
+{
+    sink.consume(s.c_str()); // expected-error-re {{call to c_str can be removed{{.*}} [hot: 90 samples, 90.0% of the profile]}}
+}
+
+} // namespace orders
+
+// 5% of the samples: reported as usual, with the weight
+void loadConfig(Sink & sink, const std::string & s)
+{
+    sink.consume(s.c_str()); // expected-warning-re {{call to c_str can be removed{{.*}} [5 samples, 5.0% of the profile]}}
+}
+
+// no samples: not reported
+void neverCalled(Sink & sink, const std::string & s)
+{
+    sink.consume(s.c_str());
+}
+
+struct Cache
+{
+    // sampled by source line
+    void update(Sink & sink, const std::string & s)
+    {
+        sink.consume(s.c_str()); // expected-warning-re {{call to c_str can be removed{{.*}} [2 samples, 2.0% of the profile]}}
+    }
+};
+
+// correctness checks aren't weighted: reported in cold functions as usual, without the weight
+bool neverCalledCheck(const char c)
+{
+    return std::isalpha(c); // expected-warning {{'isalpha' called with 'char' argument which may be UB. Use static_cast to unsigned char}}
+}
@@ -0,0 +1,17 @@
+#include <string>
+#include <string_view>
+
+struct Sink
+{
+    void consume(std::string_view s);
+};
+
+namespace orders {
+
+// 90% of the samples: hot, but the severity isn't raised by default
+void match(Sink & sink, const std::string & s)
+{
+    sink.consume(s.c_str()); // expected-warning-re {{call to c_str can be removed{{.*}} [hot: 90 samples, 90.0% of the profile]}}
+}
+
+} // namespace orders
@@ -0,0 +1,9 @@
+struct Replaced
+{
+    inline int bar(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
+
+inline int Replaced::bar()
+{
+    return 1;
+}
@@ -0,0 +1,4 @@
+struct Sampled
+{
+    inline int bar() { return 42; } // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+};
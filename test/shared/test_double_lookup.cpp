@@ -0,0 +1,108 @@
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+int read_subscript(std::map<int, int> & map, const int key)
+{
+    if (map.count(key)) { // expected-note {{'count' called here}}
+        return map[key]; // expected-warning {{'operator[]' looks up the key again after 'count'. Consider using a single lookup 'auto it = map.find(key)'}}
+    }
+    return 0;
+}
+
+int read_at(const std::unordered_map<std::string, int> & map, const std::string & name)
+{
+    return map.count(name) > 0 ? map.at(name) : -1; // expected-note {{'count' called here}} expected-warning {{'at' looks up the key again after 'count'. Consider using a single lookup 'auto it = map.find(name)'}}
+}
+
+void insert_missing(std::set<int> & set, std::unordered_set<int> * hash_set, const int key)
+{
+    if (!set.count(key)) { // expected-note {{'count' called here}}
+        set.insert(key); // expected-warning {{'insert' looks up the key again after 'count'. Consider using a single lookup 'set.insert(key).second'}}
+    }
+    if (hash_set->count(key) == 0) { // expected-note {{'count' called here}}
+        hash_set->emplace(key); // expected-warning {{'emplace' looks up the key again after 'count'. Consider using a single lookup 'hash_set->insert(key).second'}}
+    }
+}
+
+void assign_missing(std::map<int, std::string> & map, const int key)
+{
+    if (map.count(key) != 0) { // expected-note {{'count' called here}}
+        map[key] += "!"; // expected-warning {{'operator[]' looks up the key again after 'count'. Consider using a single lookup 'auto it = map.find(key)'}}
+    } else {
+        map[key] = "new"; // expected-warning {{'operator[]' looks up the key again after 'count'. Consider using a single lookup 'map.try_emplace(key, ...)'}}
+    }
+}
+
+void insert_pair(std::map<int, std::string> & map, const int key)
+{
+    if (!map.count(key)) { // expected-note {{'count' called here}}
+        map.insert({key, "new"}); // expected-warning {{'insert' looks up the key again after 'count'. Consider using a single lookup 'map.try_emplace(key, ...)'}}
+    }
+}
+
+int different_keys(std::map<int, int> & map, std::map<int, int> & other, const int key, const int other_key)
+{
+    if (map.count(key)) {
+        return map[other_key] + other[key];
+    }
+    return 0;
+}
+
+bool multi(std::multiset<int> & set, const int key)
+{
+    if (set.count(key) > 1) {
+        set.insert(key);
+    }
+    if (set.count(key)) {
+        set.insert(key);
+    }
+    return set.empty();
+}
+
+int lambda(std::map<int, int> & map, const int key)
+{
+    if (map.count(key)) {
+        auto get = [&map, key] { return map[key]; };
+        return get();
+    }
+    return 0;
+}
+
+int use(int value);
+int make();
+
+void erased(std::map<int, int> & map, const int key)
+{
+    if (map.count(key)) {
+        map.erase(key);
+        map[key] = 1;
+    }
+}
+
+void first_lookup_only(std::map<int, int> & map, const int key)
+{
+    if (!map.count(key)) { // expected-note {{'count' called here}}
+        map[key] = make(); // expected-warning {{'operator[]' looks up the key again after 'count'. Consider using a single lookup 'map.try_emplace(key, ...)'}}
+        use(map[key]);
+    }
+}
+
+void modified_key(std::set<int> & set, int key)
+{
+    if (!set.count(key)) {
+        ++key;
+        set.insert(key);
+    }
+}
+
+void in_loop(std::map<int, int> & map, const int key, const int times)
+{
+    if (map.count(key)) {
+        for (int i = 0; i < times; ++i) {
+            use(map.at(key));
+        }
+    }
+}
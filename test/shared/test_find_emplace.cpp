@@ -54,6 +54,21 @@ struct Key
     std::map<std::string, int> msi;
 };
 
+void manyFinds(std::map<int, int> & m1, std::map<int, int> & m2, const int i, const int j)
+{
+    const auto it1 = m1.find(i);
+    const auto it2 = m1.find(j); // expected-note {{'find' called here}}
+    const auto it3 = m2.find(i + j); // expected-note {{'find' called here}}
+    const auto it4 = m2.find(i - j);
+    const auto it5 = m2.find(1);
+
+    m2.emplace(j, 1);
+    m1[i + j] = 2;
+    m1.emplace(j, 3); // expected-warning {{'emplace' called after find().}}
+    m2[i + j] = 4; // expected-warning {{'operator[]' called after find().}}
+    m2[2] = 5;
+}
+
 int main()
 {
     const int abc = 10;
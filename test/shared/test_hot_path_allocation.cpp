@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+struct Order
+{
+    int id = 0;
+};
+
+void store(std::vector<Order> & orders, const Order & order)
+{
+    orders.push_back(order); // expected-warning {{'std::vector::push_back' may allocate memory on the hot path of 'on_order'}}
+}
+
+void validate(const Order & order)
+{
+    if (order.id < 0) {
+        std::abort();
+    }
+}
+
+void journal(std::vector<Order> & orders, const Order & order)
+{
+    store(orders, order);
+}
+
+// ICA-HOT
+void on_order(std::vector<Order> & orders, const Order & order)
+{
+    validate(order);
+    journal(orders, order); // 'store' is reachable through 'journal' too, only the shortest chain is reported
+    store(orders, order); // expected-note {{'store' is called here}}
+}
+
+[[clang::annotate("ica::hot")]] void on_text(const std::string & text)
+{
+    std::string copy = text; // expected-warning {{'std::string constructor' may allocate memory on the hot path of 'on_text'}}
+    copy += "!"; // expected-warning {{'std::string::operator+=' may allocate memory on the hot path of 'on_text'}}
+    auto * raw = new Order; // expected-warning {{'operator new' may allocate memory on the hot path of 'on_text'}}
+    delete raw;
+    void * buffer = malloc(16); // expected-warning {{'malloc' may allocate memory on the hot path of 'on_text'}}
+    free(buffer);
+}
+
+void on_shared() // ICA-HOT
+{
+    auto order = std::make_shared<Order>(); // expected-warning {{'std::make_shared' may allocate memory on the hot path of 'on_shared'}}
+    std::function<void()> callback = [order] {}; // expected-warning {{'std::function constructor' may allocate memory on the hot path of 'on_shared'}}
+    std::function<void()> empty = nullptr;
+    std::vector<Order> orders;
+}
+
+// ICA-HOT
+void on_placement(void * storage)
+{
+    new (storage) Order; // placement new doesn't allocate
+    std::unique_ptr<Order> moved(nullptr);
+}
+
+void not_hot(std::vector<Order> & orders)
+{
+    orders.push_back(Order{});
+    orders.reserve(100);
+}
+
+struct Book
+{
+    // ICA-HOT
+    void add(const Order & order)
+    {
+        m_orders.emplace_back(order); // expected-warning {{'std::vector::emplace_back' may allocate memory on the hot path of 'Book::add'}}
+    }
+
+    void remove(const Order &) {}
+
+    std::vector<Order> m_orders;
+};
+
+template <class T>
+void push(std::vector<T> & v, const T & value)
+{
+    v.push_back(value); // expected-warning {{'std::vector::push_back' may allocate memory on the hot path of 'on_template'}}
+}
+
+// ICA-HOT
+void on_template(std::vector<int> & v)
+{
+    push(v, 1); // expected-note {{'push<int>' is called here}}
+}
+
+// ICA-HOT
+void on_deferred(std::vector<Order> & orders, const Order & order)
+{
+    // built on the hot path, but called elsewhere
+    auto deferred = [&orders, order] { orders.push_back(order); };
+    auto copied = [orders] { return orders.size(); }; // expected-warning {{'std::vector constructor' may allocate memory on the hot path of 'on_deferred'}}
+    (void)deferred;
+    (void)copied;
+}
+
+// ICA-HOT
+template <class T>
+void on_batch(std::vector<T> & batch, const T & value)
+{
+    batch.push_back(value); // expected-warning {{'std::vector::push_back' may allocate memory on the hot path of 'on_batch<int>'}}
+}
+
+void run_batch(std::vector<int> & batch)
+{
+    on_batch(batch, 1);
+}
+
+// ICA-HOT
+void on_each(const std::vector<int> & values, std::vector<int> & out)
+{
+    // algorithms of namespace std aren't followed, but the lambdas passed to them are
+    std::for_each(values.begin(), values.end(), [&out] (const auto & x) { // expected-note-re {{'{{.*}}operator(){{.*}}' is called here}}
+        out.push_back(x); // expected-warning {{'std::vector::push_back' may allocate memory on the hot path of 'on_each'}}
+    });
+
+    const auto append = [&out] (int x) { out.emplace_back(x); }; // expected-warning {{'std::vector::emplace_back' may allocate memory on the hot path of 'on_each'}}
+    std::for_each(values.begin(), values.end(), append); // expected-note-re {{'{{.*}}operator(){{.*}}' is called here}}
+}
+
+void record(std::vector<Order> & orders, const Order & order)
+{
+    // reached from two hot functions: reported for each of them
+    orders.push_back(order); // expected-warning {{'std::vector::push_back' may allocate memory on the hot path of 'on_first'}} expected-warning {{'std::vector::push_back' may allocate memory on the hot path of 'on_second'}}
+}
+
+// ICA-HOT
+void on_first(std::vector<Order> & orders, const Order & order)
+{
+    record(orders, order); // expected-note {{'record' is called here}}
+}
+
+// ICA-HOT
+void on_second(std::vector<Order> & orders, const Order & order)
+{
+    record(orders, order); // expected-note {{'record' is called here}}
+}
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <syslog.h>
+#include <thread>
+
+std::mutex mutex;
+std::shared_mutex shared_mutex;
+std::condition_variable cv;
+
+void flush_log(const char * text)
+{
+    std::FILE * file = std::fopen("log.txt", "a"); // expected-warning {{'fopen' may block on the hot path of 'on_tick'}}
+    std::fputs(text, file); // expected-warning {{'fputs' may block on the hot path of 'on_tick'}}
+    syslog(LOG_INFO, "%s", text); // expected-warning {{'syslog' may block on the hot path of 'on_tick'}}
+}
+
+void log(const char * text)
+{
+    flush_log(text); // expected-note {{'flush_log' is called here}}
+}
+
+// ICA-HOT
+void on_tick(int value)
+{
+    std::lock_guard<std::mutex> guard(mutex); // expected-warning {{'std::lock_guard constructor' may block on the hot path of 'on_tick'}}
+    std::unique_lock<std::mutex> deferred(mutex, std::defer_lock);
+    deferred.lock(); // expected-warning {{'std::unique_lock::lock' may block on the hot path of 'on_tick'}}
+    std::shared_lock<std::shared_mutex> reader(shared_mutex); // expected-warning {{'std::shared_lock constructor' may block on the hot path of 'on_tick'}}
+    if (value < 0) {
+        log("negative"); // expected-note {{'log' is called here}}
+    }
+    std::cout << value << '\n'; // expected-warning {{'std::cout' may block on the hot path of 'on_tick'}}
+}
+
+[[clang::annotate("ica::hot")]] void on_wait()
+{
+    mutex.lock(); // expected-warning {{'std::mutex::lock' may block on the hot path of 'on_wait'}}
+    mutex.unlock();
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    cv.wait(lock); // expected-warning {{'std::condition_variable::wait' may block on the hot path of 'on_wait'}}
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // expected-warning {{'std::this_thread::sleep_for' may block on the hot path of 'on_wait'}}
+    std::this_thread::yield();
+}
+
+// ICA-HOT
+void on_dump(int value)
+{
+    std::ofstream file("dump.txt"); // expected-warning {{'std::ofstream constructor' may block on the hot path of 'on_dump'}}
+    file << value; // expected-warning {{'std::ofstream' may block on the hot path of 'on_dump'}}
+    file.flush(); // expected-warning {{'std::ofstream' may block on the hot path of 'on_dump'}}
+    const bool open = file.is_open();
+    (void)open;
+}
+
+void not_hot()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    std::cout << "not hot" << std::endl;
+}
+
+// ICA-HOT
+void on_report(int value)
+{
+    // built on the hot path, but called elsewhere
+    auto print = [value] { std::cout << value << '\n'; };
+    (void)print;
+}
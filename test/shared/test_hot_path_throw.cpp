@@ -0,0 +1,86 @@
+#include <cassert>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+int parse(const std::string & text);
+int parse_fast(const std::string & text) noexcept;
+extern "C" int c_parse(const char * text);
+
+struct Price
+{
+    int value = 0;
+};
+
+int check(int value)
+{
+    if (value < 0) {
+        throw value; // expected-warning {{'throw' may throw on the hot path of 'on_quote'}}
+    }
+    return value;
+}
+
+int validate(int value)
+{
+    return check(value); // expected-note {{'check' is called here}}
+}
+
+// ICA-HOT
+int on_quote(const std::vector<int> & levels, const std::map<int, int> & book, const std::string & text)
+{
+    assert(!levels.empty());
+    int result = levels.at(0); // expected-warning {{'std::vector::at' may throw on the hot path of 'on_quote'}}
+    result += levels[0];
+    result += book.at(1); // expected-warning {{'std::map::at' may throw on the hot path of 'on_quote'}}
+    result += std::stoi(text); // expected-warning {{'std::stoi' may throw on the hot path of 'on_quote'}}
+    result += parse(text); // expected-warning {{'parse' may throw on the hot path of 'on_quote'}}
+    result += parse_fast(text);
+    result += c_parse(text.c_str());
+    result += validate(result); // expected-note {{'validate' is called here}}
+    Price price;
+    Price copy = price;
+    return result + copy.value;
+}
+
+[[clang::annotate("ica::hot")]] int on_optional(const std::optional<int> & value, const std::function<int()> & callback)
+{
+    return value.value() // expected-warning {{'std::optional::value' may throw on the hot path of 'on_optional'}}
+        + callback() // expected-warning {{'std::function::operator()' may throw on the hot path of 'on_optional'}}
+        + *value;
+}
+
+void not_hot(const std::vector<int> & levels)
+{
+    (void)levels.at(0);
+    throw 1;
+}
+
+// ICA-HOT
+int on_order(int value)
+{
+    int * order = new int(value); // 'std::bad_alloc' is left to hot-path-allocation
+    const int result = *order;
+    delete order;
+    return result;
+}
+
+// ICA-HOT
+int on_guarded(const std::vector<int> & levels, const std::string & text)
+{
+    int result = 0;
+    try {
+        result += levels.at(0);
+        result += validate(std::stoi(text));
+        if (result < 0) {
+            throw result;
+        }
+    } catch (...) {
+        return -1;
+    }
+    // built on the hot path, but called elsewhere
+    auto deferred = [&levels] { return levels.at(1); };
+    (void)deferred;
+    return result + levels.at(2); // expected-warning {{'std::vector::at' may throw on the hot path of 'on_guarded'}}
+}
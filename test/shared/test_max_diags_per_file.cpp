@@ -0,0 +1,30 @@
+// expected-remark@1 {{2 more inline-methods-in-class diagnostics suppressed in}}
+
+struct Foo
+{
+    inline int a(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+    inline int b(); // expected-warning {{inline is used by default for method declarations/definitions in class body}}
+    inline int c();
+    inline int d();
+};
+
+int Foo::a() // expected-note {{Definition should be marked as inline instead of declaration}}
+{
+    return 1;
+}
+
+int Foo::b() // expected-note {{Definition should be marked as inline instead of declaration}}
+{
+    return 2;
+}
+
+// notes of suppressed warnings are suppressed too
+int Foo::c()
+{
+    return 3;
+}
+
+int Foo::d()
+{
+    return 4;
+}
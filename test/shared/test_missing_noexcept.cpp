@@ -0,0 +1,108 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+void may_throw();
+
+struct Buffer;
+void swap(Buffer & lhs, Buffer & rhs);
+
+struct Buffer
+{
+    Buffer() = default;
+
+    Buffer(Buffer && other) // expected-warning {{'Buffer::Buffer' can't throw, but it isn't declared as 'noexcept'}}
+        : m_data(other.m_data)
+        , m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    Buffer & operator = (Buffer && other) // expected-warning {{'Buffer::operator=' can't throw, but it isn't declared as 'noexcept'}}
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    void swap(Buffer & other) // not reported until 'swap(Buffer &, Buffer &)' is 'noexcept'
+    {
+        ::swap(*this, other);
+    }
+
+    char * m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+void swap(Buffer & lhs, Buffer & rhs) // expected-warning {{'swap' can't throw, but it isn't declared as 'noexcept'}}
+{
+    std::swap(lhs.m_data, rhs.m_data);
+    std::swap(lhs.m_size, rhs.m_size);
+}
+
+struct Named
+{
+    Named(Named && other); // the fix-it isn't provided, both declarations need 'noexcept'
+
+    Named & operator = (Named && other) noexcept = default;
+
+    std::string m_name;
+};
+
+Named::Named(Named && other) // expected-warning {{'Named::Named' can't throw, but it isn't declared as 'noexcept'}}
+    : m_name(std::move(other.m_name))
+{ }
+
+struct Throwing
+{
+    Throwing(Throwing && other)
+        : m_values(other.m_values) // copy may throw
+    { }
+
+    Throwing & operator = (Throwing && other)
+    {
+        may_throw();
+        return *this;
+    }
+
+    void swap(Throwing & other) noexcept
+    {
+        m_values.swap(other.m_values);
+    }
+
+    std::vector<int> m_values;
+};
+
+struct DefaultInitialized
+{
+    DefaultInitialized(DefaultInitialized && other) // the default member initializers allocate
+        : m_values(std::move(other.m_values))
+    { }
+
+    std::vector<int> m_values;
+    std::string m_name = "a name long enough not to fit the small string buffer";
+    std::vector<int> m_defaults{1, 2, 3};
+};
+
+struct NotCandidate
+{
+    NotCandidate(const NotCandidate & other)
+        : m_value(other.m_value)
+    { }
+
+    int get() const
+    { return m_value; }
+
+    int m_value = 0;
+};
+
+template <class T>
+struct Holder
+{
+    Holder(Holder && other)
+        : m_value(std::move(other.m_value))
+    { }
+
+    T m_value;
+};
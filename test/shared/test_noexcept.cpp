@@ -5,6 +5,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 void throwing_func();
 
@@ -160,4 +161,113 @@ int foo() noexcept // expected-warning {{there is call of non-noexcept function
 {
     int * a = new int(42); // expected-note {{non-noexcept function call is here}}
     return *a;
-}
\ No newline at end of file
+}
+// transitive calls
+void throw_inside()
+{
+    throw 1;
+}
+
+void call_throw_inside()
+{
+    throw_inside();
+}
+
+void call_transitive_throw() noexcept // expected-warning {{there is call of non-noexcept function within noexcept-specified}}
+{
+    call_throw_inside(); // expected-note {{non-noexcept function call is here}}
+}
+
+void allocate_inside()
+{
+    delete new int(42);
+}
+
+void call_transitive_new() noexcept // expected-warning {{there is call of non-noexcept function within noexcept-specified}}
+{
+    allocate_inside(); // expected-note {{non-noexcept function call is here}}
+}
+
+int safe_inside(int x)
+{
+    return x * 2;
+}
+
+void catch_inside()
+{
+    try {
+        throwing_func();
+    }
+    catch (...) {
+        // IGNORE
+    }
+}
+
+void lambda_inside()
+{
+    const auto throwing_lambda = [] { throwing_func(); };
+}
+
+void call_not_throwing() noexcept
+{
+    safe_inside(42);
+    catch_inside();
+    lambda_inside();
+}
+
+void recursive_a(int n);
+
+void recursive_b(int n)
+{
+    if (n > 0) {
+        recursive_a(n - 1);
+    }
+}
+
+void recursive_a(int n)
+{
+    if (n > 0) {
+        recursive_b(n - 1);
+    } else {
+        throwing_func();
+    }
+}
+
+void safe_recursive(int n)
+{
+    if (n > 0) {
+        safe_recursive(n - 1);
+    }
+}
+
+void call_recursive() noexcept // expected-warning {{there is call of non-noexcept function within noexcept-specified}}
+{
+    safe_recursive(2);
+    recursive_a(2); // expected-note {{non-noexcept function call is here}}
+}
+
+// direct calls are classified as the transitive ones: std functions known to throw have bodies, but are reported
+int call_at(const std::vector<int> & v) noexcept // expected-warning {{there is call of non-noexcept function within noexcept-specified}}
+{
+    return v.at(0); // expected-note {{non-noexcept function call is here}}
+}
+
+int call_stoi(const std::string & s) noexcept // expected-warning {{there is call of non-noexcept function within noexcept-specified}}
+{
+    return std::stoi(s); // expected-note {{non-noexcept function call is here}}
+}
+
+int call_at_inside(const std::vector<int> & v)
+{
+    return v.at(0);
+}
+
+int call_transitive_at(const std::vector<int> & v) noexcept // expected-warning {{there is call of non-noexcept function within noexcept-specified}}
+{
+    return call_at_inside(v); // expected-note {{non-noexcept function call is here}}
+}
+
+int call_subscript(const std::vector<int> & v) noexcept
+{
+    return v[0] + static_cast<int>(v.size());
+}
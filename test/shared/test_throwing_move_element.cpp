@@ -0,0 +1,84 @@
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Order // expected-warning {{move constructor of 'Order' isn't 'noexcept', std::vector copies the elements instead of moving them}}
+{
+    Order() = default;
+    Order(const Order &) = default;
+    Order(Order && other)
+        : m_id(std::move(other.m_id))
+    { }
+
+    std::string m_id;
+};
+
+struct Level // expected-warning {{move constructor of 'Level' isn't 'noexcept', std::deque copies the elements instead of moving them}}
+{
+    Level() = default;
+    Level(const Level & other);
+    Level(Level && other);
+};
+
+struct NoexceptMove
+{
+    NoexceptMove() = default;
+    NoexceptMove(const NoexceptMove &) = default;
+    NoexceptMove(NoexceptMove &&) noexcept = default;
+};
+
+struct DefaultedMove
+{
+    DefaultedMove() = default;
+    DefaultedMove(const DefaultedMove &) = default;
+    DefaultedMove(DefaultedMove &&) = default;
+};
+
+struct Throwing
+{
+    Throwing() = default;
+    Throwing(const Throwing &);
+    Throwing(Throwing &&);
+};
+
+// the defaulted move constructor isn't 'noexcept', as the one of the member isn't
+struct DefaultedThrowingMove // expected-warning {{move constructor of 'DefaultedThrowingMove' isn't 'noexcept', std::vector copies the elements instead of moving them}}
+{
+    DefaultedThrowingMove(const DefaultedThrowingMove &);
+    DefaultedThrowingMove(DefaultedThrowingMove &&) = default;
+
+    Throwing m_throwing;
+};
+
+struct MoveOnly
+{
+    MoveOnly() = default;
+    MoveOnly(MoveOnly &&) {}
+};
+
+struct CopyOnly
+{
+    CopyOnly() = default;
+    CopyOnly(const CopyOnly &) {}
+};
+
+struct NotStored
+{
+    NotStored(const NotStored &) = default;
+    NotStored(NotStored &&) {}
+};
+
+void use()
+{
+    std::vector<Order> orders; // expected-note {{std::vector of 'Order' is instantiated here}}
+    std::vector<Order> same_orders; // reported once
+    std::deque<Level> levels; // expected-note {{std::deque of 'Level' is instantiated here}}
+    std::vector<NoexceptMove> noexcept_moves;
+    std::vector<DefaultedMove> defaulted_moves;
+    std::vector<DefaultedThrowingMove> defaulted_throwing_moves; // expected-note {{std::vector of 'DefaultedThrowingMove' is instantiated here}}
+    std::vector<MoveOnly> move_only;
+    std::vector<CopyOnly> copy_only;
+    std::vector<int> ints;
+    std::vector<std::unique_ptr<Order>> pointers;
+}
@@ -0,0 +1,164 @@
+#!/bin/bash
+#
+# Worst-case complexity stress test: generates code with deeply nested / very long
+# constructs at growing sizes, compiles it with and without the plugin under time and
+# memory caps, and checks that the plugin overhead grows near-linearly with the size.
+#
+# Usage: do_stress.sh <clang++> <libica-plugin.so> [checks]
+#
+# Environment:
+#   ICA_STRESS_TIMEOUT   - seconds per compilation (default 120)
+#   ICA_STRESS_MEMORY_KB - virtual memory cap per compilation (default 4 GiB)
+#   ICA_STRESS_SLACK     - allowed growth of the overhead beyond linear (default 3)
+#   ICA_STRESS_STEPS     - number of size doublings (default 3)
+
+set -u
+
+COMPILER=$1
+PLUGIN=$2
+CHECKS=${3:-all}
+
+TIMEOUT=${ICA_STRESS_TIMEOUT:-120}
+MEMORY_KB=${ICA_STRESS_MEMORY_KB:-4194304}
+SLACK=${ICA_STRESS_SLACK:-3}
+STEPS=${ICA_STRESS_STEPS:-3}
+RUNS=3
+# overheads below it are treated as noise
+MIN_OVERHEAD_MS=20
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+FAILED=0
+
+# 'a + b + a + b ...' chain of N terms used as a map key (find-emplace compares such keys)
+gen_sum_chain()
+{
+    local n=$1 expr="a" i
+    for ((i = 1; i < n; ++i)); do
+        if ((i % 2)); then expr+=" + b"; else expr+=" + a"; fi
+    done
+    cat <<CODE
+#include <map>
+int f(std::map<int, int> & m, int a, int b)
+{
+    const auto it = m.find(${expr});
+    if (it == m.end()) {
+        m.emplace(${expr}, 1);
+    }
+    return ${expr};
+}
+CODE
+}
+
+# N-deep 'if' nest
+gen_if_nest()
+{
+    local n=$1 i
+    echo "int f(int x) {"
+    for ((i = 0; i < n; ++i)); do echo "if (x > ${i}) {"; done
+    echo "return x;"
+    for ((i = 0; i < n; ++i)); do echo "}"; done
+    echo "return 0; }"
+}
+
+# 'x.next().next()...next().v' chain of N calls (extractDeclRef walks it)
+gen_call_chain()
+{
+    local n=$1 expr="x" i
+    for ((i = 0; i < n; ++i)); do expr+=".next()"; done
+    cat <<CODE
+struct X { int v; X & next(); };
+int f(X & x) { return ${expr}.v; }
+CODE
+}
+
+# range-for over a container with a chain of N references to the loop variable
+gen_ref_chain()
+{
+    local n=$1 i
+    cat <<CODE
+#include <string>
+#include <vector>
+int f(const std::vector<std::string> & v)
+{
+    int size = 0;
+    for (auto s : v) {
+        const auto & r0 = s;
+CODE
+    for ((i = 1; i < n; ++i)); do echo "        const auto & r${i} = r$((i - 1));"; done
+    cat <<CODE
+        size += r$((n - 1)).size();
+    }
+    return size;
+}
+CODE
+}
+
+# prints the best of RUNS wall-clock times (ms), or nothing if the compilation fails
+measure()
+{
+    local best="" i start end spent
+    for ((i = 0; i < RUNS; ++i)); do
+        start=$(date +%s%N)
+        if ! (ulimit -v "${MEMORY_KB}"; timeout "${TIMEOUT}" "$@") > "${WORK_DIR}/log" 2>&1; then
+            cat "${WORK_DIR}/log" >&2
+            return
+        fi
+        end=$(date +%s%N)
+        spent=$(((end - start) / 1000000))
+        if [ -z "${best}" ] || ((spent < best)); then
+            best=${spent}
+        fi
+    done
+    echo "${best}"
+}
+
+run_case()
+{
+    local name=$1 base_size=$2 size step file base ica overhead
+    local first_size="" first_overhead=""
+
+    for ((step = 0; step <= STEPS; ++step)); do
+        size=$((base_size << step))
+        file="${WORK_DIR}/${name}_${size}.cpp"
+        "gen_${name}" "${size}" > "${file}"
+
+        local flags=(-std=c++17 -fsyntax-only -fbracket-depth=100000 -Wno-everything "${file}")
+        base=$(measure "${COMPILER}" "${flags[@]}")
+        ica=$(measure "${COMPILER}" "${flags[@]}" \
+            -Xclang -load -Xclang "${PLUGIN}" \
+            -Xclang -add-plugin -Xclang ica-plugin \
+            -Xclang -plugin-arg-ica-plugin -Xclang "checks=${CHECKS}")
+
+        if [ -z "${base}" ]; then
+            echo "${name}: size ${size} doesn't compile even without the plugin, skipped"
+            return
+        fi
+        if [ -z "${ica}" ]; then
+            echo "FAIL ${name}: size ${size} crashed or exceeded ${TIMEOUT} s / ${MEMORY_KB} KiB with the plugin"
+            FAILED=1
+            return
+        fi
+
+        overhead=$((ica - base))
+        ((overhead < MIN_OVERHEAD_MS)) && overhead=${MIN_OVERHEAD_MS}
+        echo "${name}: size ${size}, clang ${base} ms, with ICA ${ica} ms"
+
+        if [ -z "${first_size}" ]; then
+            first_size=${size}
+            first_overhead=${overhead}
+        elif ((overhead * first_size > first_overhead * size * SLACK)); then
+            echo "FAIL ${name}: ICA overhead grew from ${first_overhead} ms (size ${first_size}) to ${overhead} ms (size ${size})"
+            FAILED=1
+            return
+        fi
+    done
+}
+
+run_case sum_chain 625
+run_case if_nest 125
+run_case call_chain 125
+run_case ref_chain 250
+
+exit ${FAILED}